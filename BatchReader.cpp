@@ -0,0 +1,272 @@
+#include "BatchReader.h"
+#include "GaugeProfile.h"
+#include "ImageDecoder.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+BatchReader::BatchReader()
+    : m_threadCount(std::max(1u, std::thread::hardware_concurrency()))
+    , m_reducedDecode(true)
+    , m_lastElapsedSeconds(0.0)
+{
+}
+
+QStringList BatchReader::imageNameFilters()
+{
+    return {"*.png", "*.jpg", "*.jpeg", "*.bmp", "*.tiff", "*.tif"};
+}
+
+void BatchReader::addInput(const QString &path)
+{
+    QFileInfo info(path);
+    if (info.isDir())
+    {
+        // 目录按文件名排序，保证多次运行结果顺序一致
+        QStringList found;
+        QDirIterator it(path, imageNameFilters(), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            found << it.next();
+        }
+        found.sort();
+        m_files << found;
+    }
+    else if (info.isFile())
+    {
+        m_files << path;
+    }
+    else
+    {
+        qWarning() << "跳过不存在的路径:" << path;
+    }
+}
+
+bool BatchReader::addInputList(const QString &listFileName)
+{
+    QFile file(listFileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    QTextStream in(&file);
+    while (!in.atEnd())
+    {
+        const QString line = in.readLine().trimmed();
+        if (!line.isEmpty() && !line.startsWith('#'))
+        {
+            addInput(line);
+        }
+    }
+    return true;
+}
+
+void BatchReader::setThreadCount(int count)
+{
+    m_threadCount = std::max(1, count);
+}
+
+double BatchReader::lastImagesPerSecond() const
+{
+    if (m_lastElapsedSeconds <= 0.0)
+    {
+        return 0.0;
+    }
+    return m_files.size() / m_lastElapsedSeconds;
+}
+
+std::vector<BatchReading> BatchReader::run()
+{
+    std::vector<BatchReading> readings(m_files.size());
+    std::atomic<int> next(0);
+
+    // OpenCV 自身的并行会和线程池抢核，批量模式下每张图只用一个线程
+    const int cvThreads = cv::getNumThreads();
+    cv::setNumThreads(1);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 批量模式只要读数：解码方式按参数选一次，透视四边形换算到解码图坐标。
+    // 所有工作线程共享同一份只读参数，核心处理函数无状态，无需加锁
+    ImageDecoder::Plan plan;
+    plan.params = m_params;
+    if (m_reducedDecode)
+    {
+        plan = ImageDecoder::plan(m_params);
+    }
+    const GaugeParams &params = plan.params;
+    auto worker = [&]() {
+        for (int i = next++; i < m_files.size(); i = next++)
+        {
+            QElapsedTimer imageTimer;
+            imageTimer.start();
+
+            BatchReading &r = readings[i];
+            r.fileName = m_files.at(i);
+            cv::Mat image;
+            {
+                ScopedTimer decodeTimer("decode");
+                image = ImageDecoder::decode(r.fileName.toStdString(), plan);
+            }
+            r.loaded = !image.empty();
+            if (r.loaded)
+            {
+                const GaugeResult result = GaugeCore::process(image, params);
+                r.ok = result.isValid();
+                r.reading = result.reading;
+                r.confidence = result.confidence;
+            }
+            r.elapsedMs = imageTimer.nsecsElapsed() / 1e6;
+        }
+    };
+
+    const int threadCount = std::min(m_threadCount, std::max(1, int(m_files.size())));
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    m_lastElapsedSeconds = timer.nsecsElapsed() / 1e9;
+    cv::setNumThreads(cvThreads);
+    return readings;
+}
+
+bool BatchReader::writeCsv(const QString &fileName, const std::vector<BatchReading> &readings)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "file,ok,reading,confidence,ms\n";
+    for (const auto &r : readings)
+    {
+        out << '"' << QString(r.fileName).replace('"', "\"\"") << '"' << ','
+            << (r.ok ? 1 : 0) << ','
+            << (r.ok ? QString::number(r.reading, 'f', 4) : QString()) << ','
+            << QString::number(r.confidence, 'f', 3) << ','
+            << QString::number(r.elapsedMs, 'f', 2) << '\n';
+    }
+    return true;
+}
+
+// --------------------命令行入口--------------------
+int BatchReader::runCommandLine(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("仪表识别批量模式");
+    parser.addHelpOption();
+    parser.addOption({"batch", "以无界面批量模式运行"});
+    parser.addOption({{"t", "threads"}, "工作线程数（默认：CPU 核数）", "n"});
+    parser.addOption({{"o", "output"}, "结果 CSV 文件（默认输出到标准输出）", "file"});
+    parser.addOption({{"l", "list"}, "包含图像路径列表的文本文件", "file"});
+    parser.addOption({"profile", "仪表配置文件（多块表时使用第一块）", "file"});
+    parser.addOption({"full-decode", "按全分辨率彩色解码（默认按输出尺寸缩小并直接解码为灰度）"});
+    parser.addOption({"trace", "各阶段计时写为 Chrome trace JSON（chrome://tracing 或 Perfetto 打开）", "file"});
+    parser.addPositionalArgument("paths", "图像文件或目录", "<paths...>");
+    parser.process(app);
+
+    if (parser.isSet("trace"))
+    {
+        StageTrace::startRecording();
+    }
+
+    BatchReader reader;
+    if (parser.isSet("threads"))
+    {
+        reader.setThreadCount(parser.value("threads").toInt());
+    }
+    if (parser.isSet("full-decode"))
+    {
+        reader.setReducedDecodeEnabled(false);
+    }
+    if (parser.isSet("profile"))
+    {
+        // 批量图像不一定来自同一机位，只使用参数和映射表，不锁定表盘圆
+        std::vector<GaugeProfile> profiles;
+        QString error;
+        if (!GaugeProfile::load(parser.value("profile"), profiles, &error))
+        {
+            qCritical() << error;
+            return 1;
+        }
+        profiles.front().warmUp(nullptr);
+        reader.setParameters(profiles.front().params);
+    }
+    if (parser.isSet("list") && !reader.addInputList(parser.value("list")))
+    {
+        qCritical() << "无法读取列表文件:" << parser.value("list");
+        return 1;
+    }
+    for (const QString &path : parser.positionalArguments())
+    {
+        reader.addInput(path);
+    }
+    if (reader.files().isEmpty())
+    {
+        qCritical() << "没有可处理的图像";
+        return 1;
+    }
+
+    const std::vector<BatchReading> readings = reader.run();
+    if (parser.isSet("trace") && !StageTrace::writeChromeTrace(parser.value("trace").toStdString()))
+    {
+        qCritical() << "无法写入 trace 文件:" << parser.value("trace");
+    }
+
+    int failed = 0;
+    for (const auto &r : readings)
+    {
+        if (!r.ok) ++failed;
+    }
+
+    if (parser.isSet("output"))
+    {
+        if (!writeCsv(parser.value("output"), readings))
+        {
+            qCritical() << "无法写入结果文件:" << parser.value("output");
+            return 1;
+        }
+    }
+    else
+    {
+        QTextStream out(stdout);
+        for (const auto &r : readings)
+        {
+            out << r.fileName << '\t'
+                << (r.ok ? QString::number(r.reading, 'f', 4)
+                         : QString(r.loaded ? "NOT_FOUND" : "LOAD_ERROR")) << '\n';
+        }
+    }
+
+    QTextStream err(stderr);
+    err << QString("%1 张图像，失败 %2，线程 %3，耗时 %4 s，%5 张/秒\n")
+           .arg(readings.size())
+           .arg(failed)
+           .arg(reader.threadCount())
+           .arg(reader.lastElapsedSeconds(), 0, 'f', 2)
+           .arg(reader.lastImagesPerSecond(), 0, 'f', 1);
+
+    return failed == 0 ? 0 : 2;
+}
@@ -0,0 +1,65 @@
+#ifndef BATCHREADER_H
+#define BATCHREADER_H
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "GaugeCore.h"
+
+// 批量读数结果（每张图像一条）
+struct BatchReading
+{
+    QString fileName;
+    bool loaded = false;        // 图像是否成功解码
+    bool ok = false;            // 是否同时找到表盘和指针
+    double reading = 0.0;
+    double confidence = 0.0;
+    double elapsedMs = 0.0;
+};
+
+// 无界面批量识别：在线程池上并行运行完整的 GaugeCore 处理链
+class BatchReader
+{
+public:
+    BatchReader();
+
+    // 输入可以是图像文件，也可以是目录（只扫描目录下的图像文件）
+    void addInput(const QString &path);
+    // 从文本文件读取输入列表，每行一个路径
+    bool addInputList(const QString &listFileName);
+
+    void setParameters(const GaugeParams &params) { m_params = params; }
+    const GaugeParams &parameters() const { return m_params; }
+
+    void setThreadCount(int count);
+    int threadCount() const { return m_threadCount; }
+
+    // 按输出尺寸缩小解码并直接解码为灰度（默认打开），关闭后按全分辨率彩色解码
+    void setReducedDecodeEnabled(bool enabled) { m_reducedDecode = enabled; }
+    bool isReducedDecodeEnabled() const { return m_reducedDecode; }
+
+    QStringList files() const { return m_files; }
+
+    // 处理全部图像，返回按输入顺序排列的结果
+    std::vector<BatchReading> run();
+
+    // 结果写为 CSV：file,ok,reading,confidence,ms
+    static bool writeCsv(const QString &fileName, const std::vector<BatchReading> &readings);
+
+    double lastElapsedSeconds() const { return m_lastElapsedSeconds; }
+    double lastImagesPerSecond() const;
+
+    static QStringList imageNameFilters();
+
+    // 命令行入口：Instrument_identification --batch [选项] <路径...>
+    static int runCommandLine(int argc, char *argv[]);
+
+private:
+    QStringList m_files;
+    GaugeParams m_params;
+    int m_threadCount;
+    bool m_reducedDecode;
+    double m_lastElapsedSeconds;
+};
+
+#endif // BATCHREADER_H
@@ -0,0 +1,660 @@
+#include "CircleDetector.h"
+#include "GaugeCore.h"
+#include <cmath>
+#include <random>
+
+namespace CircleDetector
+{
+
+// --------------------霍夫圆检测--------------------
+Detection houghCircles(const cv::Mat &edges, int minRadius, int maxRadius)
+{
+    Detection detection;
+    if (edges.empty())
+    {
+        return detection;
+    }
+
+    // 每个线程复用同一个结果数组，连续帧不再重新分配
+    thread_local std::vector<cv::Vec3f> circles;
+    circles.clear();
+    cv::HoughCircles(edges, circles, cv::HOUGH_GRADIENT, 1,
+                     edges.rows/16, 100, 30, minRadius, maxRadius);
+
+    // 只保留置信度最大的第一个
+    if (!circles.empty())
+    {
+        detection.found = true;
+        detection.circle = circles[0];
+        detection.score = std::numeric_limits<double>::quiet_NaN();
+    }
+    return detection;
+}
+
+
+// --------------------最小二乘拟合--------------------
+bool fitCircleLeastSquares(const std::vector<cv::Point2f> &points, cv::Vec3f &circle)
+{
+    if (points.size() < 3)
+    {
+        return false;
+    }
+
+    // 以质心为原点，减小数值误差
+    double mx = 0, my = 0;
+    for (const auto &p : points)
+    {
+        mx += p.x;
+        my += p.y;
+    }
+    mx /= points.size();
+    my /= points.size();
+
+    // 代数拟合 x^2 + y^2 + D x + E y + F = 0 的正规方程
+    double sxx = 0, sxy = 0, syy = 0, sx = 0, sy = 0, sz = 0, sxz = 0, syz = 0;
+    for (const auto &p : points)
+    {
+        const double x = p.x - mx;
+        const double y = p.y - my;
+        const double z = x * x + y * y;
+        sxx += x * x;
+        sxy += x * y;
+        syy += y * y;
+        sx += x;
+        sy += y;
+        sz += z;
+        sxz += x * z;
+        syz += y * z;
+    }
+    const double n = double(points.size());
+    const double a[3][3] = { { sxx, sxy, sx }, { sxy, syy, sy }, { sx, sy, n } };
+    const double b[3] = { -sxz, -syz, -sz };
+
+    auto det3 = [](const double m[3][3]) {
+        return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+    };
+    const double det = det3(a);
+    if (std::abs(det) < 1e-9)
+    {
+        return false;
+    }
+
+    // 克莱姆法则
+    double solution[3];
+    for (int k = 0; k < 3; ++k)
+    {
+        double m[3][3];
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                m[i][j] = j == k ? b[i] : a[i][j];
+            }
+        }
+        solution[k] = det3(m) / det;
+    }
+
+    const double cx = -solution[0] / 2;
+    const double cy = -solution[1] / 2;
+    const double r2 = cx * cx + cy * cy - solution[2];
+    if (r2 <= 0)
+    {
+        return false;
+    }
+    circle = cv::Vec3f(float(cx + mx), float(cy + my), float(std::sqrt(r2)));
+    return true;
+}
+
+
+// --------------------梯度投票--------------------
+namespace
+{
+// 梯度方向与径向夹角的余弦下限：半径统计时只计指向圆心（或背离圆心）的边缘像素
+const double RadialCosine = 0.9;
+
+// 圆心累加器每格的像素数，以及粗半径统计时合并的相邻半径数
+const int AccCell = 2;
+const int RadiusWindow = 2;
+
+// 精化最后一轮的内点容差（像素）
+const float RefineTolerance = 1.5f;
+
+// 边缘像素及其单位梯度方向（梯度为空时只取坐标）。stride > 1 时按扫描顺序每 stride 个取一个
+void collectEdgePoints(const cv::Mat &edges, const EdgeGradients &gradients, int stride,
+                       std::vector<cv::Point> &points, std::vector<cv::Point2f> &normals)
+{
+    const bool withGradients = !gradients.empty() && gradients.dx.size() == edges.size();
+    int counter = 0;
+    for (int y = 0; y < edges.rows; ++y)
+    {
+        const uchar *e = edges.ptr<uchar>(y);
+        const int16_t *gx = withGradients ? gradients.dx.ptr<int16_t>(y) : nullptr;
+        const int16_t *gy = withGradients ? gradients.dy.ptr<int16_t>(y) : nullptr;
+        for (int x = 0; x < edges.cols; ++x)
+        {
+            if (!e[x] || counter++ % stride != 0)
+            {
+                continue;
+            }
+            if (!withGradients)
+            {
+                points.push_back(cv::Point(x, y));
+                continue;
+            }
+            const float norm = std::sqrt(float(gx[x]) * gx[x] + float(gy[x]) * gy[x]);
+            if (norm <= 0)
+            {
+                continue;
+            }
+            points.push_back(cv::Point(x, y));
+            normals.push_back(cv::Point2f(gx[x] / norm, gy[x] / norm));
+        }
+    }
+}
+
+// 累加器中 3x3 邻域和最大的位置，返回邻域内加权质心（亚像素圆心）
+bool findPeak(const cv::Mat &acc, cv::Point2f &center, int &votes)
+{
+    int bestSum = 0;
+    cv::Point best(-1, -1);
+    for (int y = 1; y < acc.rows - 1; ++y)
+    {
+        const int *above = acc.ptr<int>(y - 1);
+        const int *row = acc.ptr<int>(y);
+        const int *below = acc.ptr<int>(y + 1);
+        for (int x = 1; x < acc.cols - 1; ++x)
+        {
+            if (row[x] == 0)
+            {
+                continue;
+            }
+            const int sum = above[x - 1] + above[x] + above[x + 1]
+                    + row[x - 1] + row[x] + row[x + 1]
+                    + below[x - 1] + below[x] + below[x + 1];
+            if (sum > bestSum)
+            {
+                bestSum = sum;
+                best = cv::Point(x, y);
+            }
+        }
+    }
+    if (bestSum == 0)
+    {
+        return false;
+    }
+
+    double sx = 0, sy = 0;
+    for (int dy = -1; dy <= 1; ++dy)
+    {
+        const int *row = acc.ptr<int>(best.y + dy);
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            sx += double(row[best.x + dx]) * (best.x + dx);
+            sy += double(row[best.x + dx]) * (best.y + dy);
+        }
+    }
+    center = cv::Point2f(float(sx / bestSum), float(sy / bestSum));
+    votes = bestSum;
+    return true;
+}
+}
+
+Detection refineCircle(const cv::Mat &edges, const EdgeGradients &gradients, const cv::Vec3f &initial,
+                       float band, int minRadius, int maxRadius)
+{
+    Detection detection;
+    if (edges.empty() || gradients.empty() || edges.size() != gradients.dx.size() || initial[2] <= 0)
+    {
+        return detection;
+    }
+
+    // 只扫描圆环的外接矩形
+    const int outer = int(std::ceil(initial[2] + band)) + 1;
+    const cv::Rect bounds = cv::Rect(int(initial[0]) - outer, int(initial[1]) - outer, 2 * outer + 1, 2 * outer + 1)
+            & cv::Rect(0, 0, edges.cols, edges.rows);
+
+    // 候选点：圆环内梯度沿径向的边缘像素。点集和直方图都放在每个线程复用的数组中，连续帧不再分配
+    thread_local std::vector<cv::Point2f> candidates;
+    candidates.clear();
+    {
+        const float inner = std::max(0.0f, initial[2] - band);
+        const float inner2 = inner * inner;
+        const float outer2 = (initial[2] + band) * (initial[2] + band);
+        for (int y = bounds.y; y < bounds.y + bounds.height; ++y)
+        {
+            const uchar *e = edges.ptr<uchar>(y);
+            const int16_t *gx = gradients.dx.ptr<int16_t>(y);
+            const int16_t *gy = gradients.dy.ptr<int16_t>(y);
+            const float ry = y - initial[1];
+            for (int x = bounds.x; x < bounds.x + bounds.width; ++x)
+            {
+                if (!e[x])
+                {
+                    continue;
+                }
+                const float rx = x - initial[0];
+                const float d2 = rx * rx + ry * ry;
+                if (d2 < inner2 || d2 > outer2)
+                {
+                    continue;
+                }
+                const float radial = rx * gx[x] + ry * gy[x];
+                const float norm2 = d2 * (float(gx[x]) * gx[x] + float(gy[x]) * gy[x]);
+                if (radial * radial < RadialCosine * RadialCosine * norm2)
+                {
+                    continue;
+                }
+                candidates.push_back(cv::Point2f(float(x), float(y)));
+            }
+        }
+    }
+
+    cv::Vec3f circle = initial;
+    if (band > RadiusWindow + 1.0f)
+    {
+        // 圆环较宽时可能同时包含表盘外圈的内外两条边。两条边同心，整体拟合先把圆心拉准，
+        // 再按新圆心的距离直方图选出边缘最多的半径
+        cv::Vec3f fitted;
+        if (fitCircleLeastSquares(candidates, fitted))
+        {
+            circle[0] = fitted[0];
+            circle[1] = fitted[1];
+        }
+
+        const int bins = int(std::ceil(2 * band)) + 1;
+        const float base = initial[2] - band;
+        thread_local std::vector<int> histogram;
+        histogram.assign(size_t(bins), 0);
+        for (const auto &p : candidates)
+        {
+            const int bin = cvRound(cv::norm(p - cv::Point2f(circle[0], circle[1])) - base);
+            if (bin >= 0 && bin < bins)
+            {
+                ++histogram[bin];
+            }
+        }
+        int bestCount = 0;
+        for (int i = 0; i < bins; ++i)
+        {
+            int count = 0;
+            for (int k = std::max(0, i - RadiusWindow); k <= std::min(bins - 1, i + RadiusWindow); ++k)
+            {
+                count += histogram[k];
+            }
+            if (count > bestCount)
+            {
+                bestCount = count;
+                circle[2] = base + i;
+            }
+        }
+    }
+
+    // 在候选点中取当前圆附近的点做最小二乘拟合，容差逐次收紧
+    thread_local std::vector<cv::Point2f> inliers;
+    const float tolerances[] = { RadiusWindow + 1.0f, RefineTolerance };
+    for (float tolerance : tolerances)
+    {
+        inliers.clear();
+        for (const auto &p : candidates)
+        {
+            const double d = cv::norm(p - cv::Point2f(circle[0], circle[1]));
+            if (std::abs(d - circle[2]) <= tolerance)
+            {
+                inliers.push_back(p);
+            }
+        }
+
+        cv::Vec3f fitted;
+        if (!fitCircleLeastSquares(inliers, fitted)
+                || fitted[2] < minRadius - tolerance || fitted[2] > maxRadius + tolerance)
+        {
+            break;
+        }
+        circle = fitted;
+    }
+
+    if (inliers.empty())
+    {
+        return detection;
+    }
+
+    detection.found = true;
+    detection.circle = circle;
+    detection.score = std::min(1.0, inliers.size() / (2 * CV_PI * circle[2]));
+    return detection;
+}
+
+Detection gradientVote(const cv::Mat &edges, const EdgeGradients &gradients,
+                       int minRadius, int maxRadius)
+{
+    Detection detection;
+    if (edges.empty() || gradients.empty() || edges.size() != gradients.dx.size())
+    {
+        return detection;
+    }
+    minRadius = std::max(1, minRadius);
+    maxRadius = std::max(minRadius, maxRadius);
+
+    // 边缘点、累加器和半径直方图都放在每个线程复用的缓冲区中，连续帧不再分配
+    thread_local std::vector<cv::Point> points;
+    thread_local std::vector<cv::Point2f> normals;
+    points.clear();
+    normals.clear();
+    collectEdgePoints(edges, gradients, 1, points, normals);
+    if (points.empty())
+    {
+        return detection;
+    }
+
+    // 圆心投票：沿梯度正反两个方向各走 [minRadius, maxRadius]。
+    // 半径几百像素时梯度方向 1 度的误差就让投票偏出数个像素，累加器用 AccCell 像素一格
+    const int width = edges.cols;
+    const int height = edges.rows;
+    thread_local cv::Mat acc;
+    acc.create((height + AccCell - 1) / AccCell, (width + AccCell - 1) / AccCell, CV_32SC1);
+    acc.setTo(cv::Scalar(0));
+    const float scale = 1.0f / AccCell;
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        for (int sign = -1; sign <= 1; sign += 2)
+        {
+            const float vx = sign * normals[i].x;
+            const float vy = sign * normals[i].y;
+            float cx = points[i].x + vx * minRadius;
+            float cy = points[i].y + vy * minRadius;
+            for (int r = minRadius; r <= maxRadius; ++r, cx += vx, cy += vy)
+            {
+                if (cx < 0 || cy < 0 || cx >= width || cy >= height)
+                {
+                    break;
+                }
+                ++acc.at<int>(int(cy * scale), int(cx * scale));
+            }
+        }
+    }
+
+    cv::Point2f cell;
+    int votes = 0;
+    if (!findPeak(acc, cell, votes))
+    {
+        return detection;
+    }
+    const cv::Point2f center((cell.x + 0.5f) * AccCell, (cell.y + 0.5f) * AccCell);
+
+    // 半径直方图：只统计梯度与径向一致的边缘像素
+    thread_local std::vector<int> histogram;
+    histogram.assign(size_t(maxRadius - minRadius + 1), 0);
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const float rx = points[i].x - center.x;
+        const float ry = points[i].y - center.y;
+        const float d = std::sqrt(rx * rx + ry * ry);
+        const int bin = cvRound(d) - minRadius;
+        if (d <= 0 || bin < 0 || bin >= int(histogram.size()))
+        {
+            continue;
+        }
+        if (std::abs(rx * normals[i].x + ry * normals[i].y) < RadialCosine * d)
+        {
+            continue;
+        }
+        ++histogram[bin];
+    }
+
+    // 粗圆心有一两个像素的误差，相邻 2 * RadiusWindow + 1 个半径合并计数
+    int bestCount = 0;
+    int bestBin = 0;
+    for (int i = 0; i < int(histogram.size()); ++i)
+    {
+        int count = 0;
+        for (int k = std::max(0, i - RadiusWindow); k <= std::min(int(histogram.size()) - 1, i + RadiusWindow); ++k)
+        {
+            count += histogram[k];
+        }
+        if (count > bestCount)
+        {
+            bestCount = count;
+            bestBin = i;
+        }
+    }
+    if (bestCount == 0)
+    {
+        return detection;
+    }
+
+    const cv::Vec3f coarse(center.x, center.y, float(minRadius + bestBin));
+    return refineCircle(edges, gradients, coarse, RadiusWindow + 1.0f, minRadius, maxRadius);
+}
+
+
+// --------------------RANSAC--------------------
+namespace
+{
+// 参与 RANSAC 的边缘点上限，超出时按扫描顺序等间隔抽取
+const int RansacMaxPoints = 2000;
+const int RansacMaxIterations = 500;
+// 点到圆周距离不超过此值（像素）即为内点
+const float RansacTolerance = 2.0f;
+// 以 99% 的概率至少抽到一组全是内点的样本
+const double RansacConfidence = 0.99;
+// 固定种子，同一帧多次检测结果一致
+const unsigned RansacSeed = 20240601u;
+
+// 三点确定的圆，三点（近似）共线时返回 false
+bool circleFromPoints(const cv::Point &a, const cv::Point &b, const cv::Point &c, cv::Vec3f &circle)
+{
+    const double bx = b.x - a.x;
+    const double by = b.y - a.y;
+    const double cx = c.x - a.x;
+    const double cy = c.y - a.y;
+    const double d = 2 * (bx * cy - by * cx);
+    if (std::abs(d) < 1e-6)
+    {
+        return false;
+    }
+    const double b2 = bx * bx + by * by;
+    const double c2 = cx * cx + cy * cy;
+    const double ux = (cy * b2 - by * c2) / d;
+    const double uy = (bx * c2 - cx * b2) / d;
+    circle = cv::Vec3f(float(a.x + ux), float(a.y + uy), float(std::sqrt(ux * ux + uy * uy)));
+    return true;
+}
+
+// 梯度方向是否沿径向（指向或背离圆心）
+inline bool isRadial(const cv::Point &p, const cv::Point2f &normal, const cv::Vec3f &circle)
+{
+    const float rx = p.x - circle[0];
+    const float ry = p.y - circle[1];
+    const float d = std::sqrt(rx * rx + ry * ry);
+    return std::abs(rx * normal.x + ry * normal.y) >= RadialCosine * d;
+}
+}
+
+Detection ransac(const cv::Mat &edges, const EdgeGradients &gradients, int minRadius, int maxRadius)
+{
+    Detection detection;
+    if (edges.empty())
+    {
+        return detection;
+    }
+
+    const int edgeCount = cv::countNonZero(edges);
+    const int stride = std::max(1, (edgeCount + RansacMaxPoints - 1) / RansacMaxPoints);
+    thread_local std::vector<cv::Point> points;
+    thread_local std::vector<cv::Point2f> normals;
+    points.clear();
+    normals.clear();
+    collectEdgePoints(edges, gradients, stride, points, normals);
+    const bool withGradients = !normals.empty();
+    if (points.size() < 3)
+    {
+        return detection;
+    }
+
+    std::mt19937 rng(RansacSeed);
+    std::uniform_int_distribution<int> pick(0, int(points.size()) - 1);
+    int bestInliers = 0;
+    cv::Vec3f best;
+    int required = RansacMaxIterations;
+    for (int iteration = 0; iteration < required; ++iteration)
+    {
+        const int i0 = pick(rng);
+        const int i1 = pick(rng);
+        const int i2 = pick(rng);
+        cv::Vec3f circle;
+        if (i0 == i1 || i1 == i2 || i0 == i2
+                || !circleFromPoints(points[i0], points[i1], points[i2], circle)
+                || circle[2] < minRadius || circle[2] > maxRadius)
+        {
+            continue;
+        }
+        // 有梯度时三个样本点的梯度都要沿径向，绝大多数错误假设在这里就被排除
+        if (withGradients && (!isRadial(points[i0], normals[i0], circle)
+                              || !isRadial(points[i1], normals[i1], circle)
+                              || !isRadial(points[i2], normals[i2], circle)))
+        {
+            continue;
+        }
+
+        int inliers = 0;
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            const float rx = points[i].x - circle[0];
+            const float ry = points[i].y - circle[1];
+            if (std::abs(std::sqrt(rx * rx + ry * ry) - circle[2]) <= RansacTolerance
+                    && (!withGradients || isRadial(points[i], normals[i], circle)))
+            {
+                ++inliers;
+            }
+        }
+        if (inliers > bestInliers)
+        {
+            bestInliers = inliers;
+            best = circle;
+
+            // 按当前内点率更新所需的迭代次数
+            const double w = double(inliers) / points.size();
+            const double miss = 1.0 - w * w * w;
+            if (miss <= 0.0)
+            {
+                break;
+            }
+            required = std::min(RansacMaxIterations,
+                                int(std::ceil(std::log(1.0 - RansacConfidence) / std::log(miss))));
+        }
+    }
+    if (bestInliers < 3)
+    {
+        return detection;
+    }
+
+    // 内点最小二乘
+    thread_local std::vector<cv::Point2f> inliers;
+    inliers.clear();
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        const float rx = points[i].x - best[0];
+        const float ry = points[i].y - best[1];
+        if (std::abs(std::sqrt(rx * rx + ry * ry) - best[2]) <= RansacTolerance
+                && (!withGradients || isRadial(points[i], normals[i], best)))
+        {
+            inliers.push_back(cv::Point2f(float(points[i].x), float(points[i].y)));
+        }
+    }
+    cv::Vec3f fitted;
+    if (fitCircleLeastSquares(inliers, fitted) && fitted[2] >= minRadius - RansacTolerance
+            && fitted[2] <= maxRadius + RansacTolerance)
+    {
+        best = fitted;
+    }
+
+    // 有梯度时再用全部边缘像素精化；置信度为内点数与圆周长之比（内点覆盖的圆周比例）
+    if (withGradients)
+    {
+        detection = refineCircle(edges, gradients, best, RansacTolerance + 1.0f, minRadius, maxRadius);
+        if (detection.found)
+        {
+            return detection;
+        }
+    }
+    detection.found = true;
+    detection.circle = best;
+    detection.score = std::min(1.0, double(inliers.size()) * stride / (2 * CV_PI * best[2]));
+    return detection;
+}
+
+
+// --------------------金字塔--------------------
+Detection pyramid(const cv::Mat &blurred, const cv::Mat &edges, const EdgeGradients &gradients,
+                  const GaugeParams &params)
+{
+    Detection detection;
+    if (blurred.empty())
+    {
+        return detection;
+    }
+
+    const int levels = std::max(1, std::min(MaxPyramidLevels, params.circlePyramidLevels));
+    const int scale = 1 << levels;
+    // 每层和小图的边缘、梯度放在每个线程复用的缓冲区中，同尺寸的连续帧由 create 直接复用
+    thread_local cv::Mat pyramidLevels[MaxPyramidLevels];
+    const cv::Mat *small = &blurred;
+    for (int i = 0; i < levels; ++i)
+    {
+        cv::pyrDown(*small, pyramidLevels[i]);
+        small = &pyramidLevels[i];
+    }
+
+    GaugeParams coarseParams = params;
+    coarseParams.minRadius = std::max(1, params.minRadius / scale);
+    coarseParams.maxRadius = std::max(coarseParams.minRadius, (params.maxRadius + scale - 1) / scale);
+
+    thread_local cv::Mat smallEdges;
+    thread_local EdgeGradients smallGradients;
+    GaugeCore::detectEdges(*small, smallEdges, coarseParams, &smallGradients);
+
+    Detection coarse = detect(params.circleMethod, smallEdges, smallGradients,
+                              coarseParams.minRadius, coarseParams.maxRadius);
+    if (!coarse.found)
+    {
+        return detection;
+    }
+
+    // pyrDown 的第 x 个像素对应原图第 2x 个像素
+    const cv::Vec3f initial(coarse.circle[0] * scale, coarse.circle[1] * scale, coarse.circle[2] * scale);
+    if (gradients.empty())
+    {
+        coarse.circle = initial;
+        return coarse;
+    }
+
+    // 小图上一个像素的误差放大后是 scale 个像素，圆环宽度按此留余量
+    const float band = 1.5f * scale + RadiusWindow;
+    detection = refineCircle(edges, gradients, initial, band, params.minRadius, params.maxRadius);
+    return detection.found ? detection : Detection();
+}
+
+
+// --------------------方法选择--------------------
+Detection detect(Method method, const cv::Mat &edges, const EdgeGradients &gradients,
+                 int minRadius, int maxRadius)
+{
+    switch (method)
+    {
+    case GradientVoteMethod:
+        // 投票依赖梯度，没有梯度时退回霍夫
+        if (!gradients.empty())
+        {
+            return gradientVote(edges, gradients, minRadius, maxRadius);
+        }
+        return houghCircles(edges, minRadius, maxRadius);
+    case RansacMethod:
+        return ransac(edges, gradients, minRadius, maxRadius);
+    default:
+        return houghCircles(edges, minRadius, maxRadius);
+    }
+}
+
+}
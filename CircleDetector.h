@@ -0,0 +1,65 @@
+#ifndef CIRCLEDETECTOR_H
+#define CIRCLEDETECTOR_H
+
+#include <opencv2/opencv.hpp>
+
+struct EdgeGradients;
+struct GaugeParams;
+
+// 表盘圆检测。所有方法都只使用边缘检测阶段的输出（边缘图 + Sobel 梯度），
+// 不再在内部重复做 Sobel/Canny
+namespace CircleDetector
+{
+
+enum Method
+{
+    HoughMethod,        // cv::HoughCircles(HOUGH_GRADIENT)，取第一个圆，不给出置信度
+    GradientVoteMethod, // 沿边缘梯度方向投票求圆心，再用半径直方图求半径
+    RansacMethod        // 边缘点上三点采样 RANSAC + 最小二乘精化
+};
+
+// 金字塔最多缩小的层数（1/8）
+const int MaxPyramidLevels = 3;
+
+struct Detection
+{
+    bool found = false;
+    cv::Vec3f circle;       // 圆心 x、y 与半径
+    double score = 0.0;     // 方法相关的置信度，0-1；霍夫方法不提供，为 NaN
+};
+
+// 代数最小二乘圆拟合（至少 3 个点）
+bool fitCircleLeastSquares(const std::vector<cv::Point2f> &points, cv::Vec3f &circle);
+
+// 半径范围 [minRadius, maxRadius]
+Detection houghCircles(const cv::Mat &edges, int minRadius, int maxRadius);
+
+// 每个边缘像素沿梯度正反两个方向、在半径范围内给圆心投票（累加器为 2x2 像素一格），
+// 取票数最多的位置为粗圆心；再取梯度指向圆心的边缘像素到圆心距离的直方图峰值为粗半径，
+// 最后用峰值附近的边缘像素做最小二乘拟合得到亚像素的圆心和半径。
+// score 为拟合内点数与圆周长之比
+Detection gradientVote(const cv::Mat &edges, const EdgeGradients &gradients,
+                       int minRadius, int maxRadius);
+
+// 在 initial 附近宽 band 像素的圆环内，用梯度沿径向的边缘像素迭代做最小二乘拟合
+Detection refineCircle(const cv::Mat &edges, const EdgeGradients &gradients, const cv::Vec3f &initial,
+                       float band, int minRadius, int maxRadius);
+
+// 从边缘点中抽样（最多 2000 个）做三点 RANSAC，半径限制在 [minRadius, maxRadius]，
+// 有梯度时要求样本点和内点的梯度沿径向；最后对内点做最小二乘（有梯度时用全部边缘像素精化）。
+// score 为内点覆盖的圆周比例，而不是霍夫那样直接取第一个圆
+Detection ransac(const cv::Mat &edges, const EdgeGradients &gradients, int minRadius, int maxRadius);
+
+// 按 method 调用上面的某个检测方法
+Detection detect(Method method, const cv::Mat &edges, const EdgeGradients &gradients,
+                 int minRadius, int maxRadius);
+
+// 金字塔模式：模糊图缩小 params.circlePyramidLevels 层（每层 1/2）后重新做边缘检测，
+// 用 params.circleMethod 在小图上检测，半径范围按比例缩小（霍夫的 minDist 取小图行数的 1/16，自动随层缩小）；
+// 再把结果放大回原分辨率，在窄圆环内用原分辨率的边缘和梯度精化
+Detection pyramid(const cv::Mat &blurred, const cv::Mat &edges, const EdgeGradients &gradients,
+                  const GaugeParams &params);
+
+}
+
+#endif // CIRCLEDETECTOR_H
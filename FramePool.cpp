@@ -0,0 +1,75 @@
+#include "FramePool.h"
+#include <algorithm>
+
+FramePool::FramePool(size_t capacity)
+    : m_capacity(capacity ? capacity : 1)
+    , m_allocations(0)
+    , m_reuses(0)
+{
+}
+
+// 引用计数用原子操作读取：计数为 1 时其他线程对这块缓冲区的访问都已结束
+bool FramePool::isIdle(const cv::Mat &buffer)
+{
+    return buffer.u && CV_XADD(&buffer.u->refcount, 0) == 1;
+}
+
+cv::Mat FramePool::acquire(const cv::Size &size, int type)
+{
+    for (const cv::Mat &buffer : m_buffers)
+    {
+        if (buffer.size() == size && buffer.type() == type && isIdle(buffer))
+        {
+            ++m_reuses;
+            return buffer;
+        }
+    }
+
+    ++m_allocations;
+    cv::Mat buffer(size, type);
+    if (m_buffers.size() >= m_capacity)
+    {
+        // 池满时腾出一块空闲缓冲区（通常是换分辨率前留下的）；全部在使用中时新缓冲区不进池
+        auto idle = std::find_if(m_buffers.begin(), m_buffers.end(), &FramePool::isIdle);
+        if (idle == m_buffers.end())
+        {
+            return buffer;
+        }
+        m_buffers.erase(idle);
+    }
+    m_buffers.push_back(buffer);
+    return buffer;
+}
+
+void FramePool::reserve(const cv::Size &size, int type, size_t count)
+{
+    size_t existing = 0;
+    for (const cv::Mat &buffer : m_buffers)
+    {
+        if (buffer.size() == size && buffer.type() == type)
+        {
+            ++existing;
+        }
+    }
+    m_capacity = std::max(m_capacity, m_buffers.size() + count - std::min(count, existing));
+    for (; existing < count; ++existing)
+    {
+        ++m_allocations;
+        m_buffers.push_back(cv::Mat(size, type));
+    }
+}
+
+void FramePool::trim()
+{
+    m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(), &FramePool::isIdle), m_buffers.end());
+}
+
+size_t FramePool::bytes(MemoryCounter &counter) const
+{
+    size_t total = 0;
+    for (const cv::Mat &buffer : m_buffers)
+    {
+        total += counter.add(buffer);
+    }
+    return total;
+}
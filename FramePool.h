@@ -0,0 +1,46 @@
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include "MemoryUsage.h"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// 按尺寸和类型复用的图像缓冲区池，每个工作线程（或每块表）一个。
+// 池中保留每块缓冲区的一个引用，外部的 Mat 全部释放（引用计数回到 1）后即可再次取出，
+// 调用方不需要显式归还；同尺寸的连续帧在预热后不再分配内存。
+// acquire 和统计只能在所属线程中调用，取出的 Mat 可以交给其他线程、在任意线程释放
+class FramePool
+{
+public:
+    explicit FramePool(size_t capacity = 64);
+
+    // 取一块空闲缓冲区，内容未初始化；没有相同尺寸和类型的空闲缓冲区时新分配。
+    // 传给 GaugeCore 各阶段作输出时，尺寸和类型相符，阶段内的 create 直接写入这块缓冲区
+    cv::Mat acquire(const cv::Size &size, int type);
+
+    // 预先分配，使池中至少有 count 块该尺寸和类型的缓冲区（容量不够时随之扩大）。
+    // 同时在用的缓冲区数有确定上限时（例如流水执行器的在途帧数）在开始前调用，运行中不再分配
+    void reserve(const cv::Size &size, int type, size_t count);
+
+    // 释放全部空闲缓冲区
+    void trim();
+
+    size_t bufferCount() const { return m_buffers.size(); }
+    // 池中缓冲区的字节数（包括正被外部使用的），已经计过的数据块不重复计
+    size_t bytes(MemoryCounter &counter) const;
+
+    // 新分配的次数，同尺寸的连续帧预热后应保持不变
+    uint64_t allocations() const { return m_allocations; }
+    uint64_t reuses() const { return m_reuses; }
+
+private:
+    static bool isIdle(const cv::Mat &buffer);
+
+    size_t m_capacity;
+    std::vector<cv::Mat> m_buffers;
+    uint64_t m_allocations;
+    uint64_t m_reuses;
+};
+
+#endif // FRAMEPOOL_H
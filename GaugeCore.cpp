@@ -0,0 +1,690 @@
+#include "GaugeCore.h"
+#include "PerspectiveMap.h"
+#include "GrayWarpKernel.h"
+#include "ParallelCanny.h"
+#include <cmath>
+#include <limits>
+
+namespace GaugeCore
+{
+
+// 指针检测时丢弃梯度方向与径向夹角余弦大于此值的边缘像素（约 25 度以内）
+const float RadialEdgeCosine = 0.9f;
+
+// --------------------透视变换--------------------
+namespace
+{
+// 调用方固定持有的映射表优先，否则按参数从全局缓存查找
+std::shared_ptr<const PerspectiveMap> perspectiveMap(const GaugeParams &params,
+                                                     const std::shared_ptr<const PerspectiveMap> &map)
+{
+    return map ? map : PerspectiveMapCache::instance().get(params.sourcePoints,
+                                                           cv::Size(params.outputWidth, params.outputHeight));
+}
+}
+
+void applyPerspectiveTransform(const cv::Mat &src, cv::Mat &dst, const GaugeParams &params,
+                               const std::shared_ptr<const PerspectiveMap> &map)
+{
+    if (src.empty() || params.sourcePoints.size() != 4)
+    {
+        dst.release();
+        return;
+    }
+
+    // 变换编译成定点映射表并缓存，几何参数不变时只做一次 remap
+    perspectiveMap(params, map)->apply(src, dst);
+}
+
+
+// --------------------高斯模糊--------------------
+void convertToGray(const cv::Mat &src, cv::Mat &dst)
+{
+    if (src.empty())
+    {
+        dst.release();
+        return;
+    }
+
+    // 直接解码为灰度的原图，透视变换后已经是灰度图
+    if (src.channels() == 1)
+    {
+        src.copyTo(dst);
+        return;
+    }
+    cv::cvtColor(src, dst, cv::COLOR_BGR2GRAY);
+}
+
+void applyGaussianBlur(const cv::Mat &gray, cv::Mat &dst, const GaugeParams &params)
+{
+    if (gray.empty())
+    {
+        dst.release();
+        return;
+    }
+
+    if (gray.type() != CV_8UC1)
+    {
+        cv::GaussianBlur(gray, dst, cv::Size(GaugeBlurSize, GaugeBlurSize), params.sigmaX, params.sigmaY);
+        return;
+    }
+
+    // Q8 定点可分离高斯（与精确结果相差不超过 1 个灰度级），或盒式滤波近似；都支持原地处理
+    dst.create(gray.size(), CV_8UC1);
+    if (params.blurMode == BlurEngine::FastBox)
+    {
+        BlurEngine::boxBlurApprox(gray.ptr<uint8_t>(), gray.step, dst.ptr<uint8_t>(), dst.step,
+                                  gray.cols, gray.rows, params.sigmaX, params.sigmaY);
+    }
+    else
+    {
+        BlurEngine::gaussianBlur(gray.ptr<uint8_t>(), gray.step, dst.ptr<uint8_t>(), dst.step,
+                                 gray.cols, gray.rows, GaugeBlurSize, params.sigmaX, params.sigmaY);
+    }
+}
+
+
+// --------------------融合的透视变换 + 灰度 + 模糊--------------------
+namespace
+{
+bool fusedWarpSupported(const cv::Mat &src)
+{
+    return src.type() == CV_8UC3;
+}
+
+GrayWarp::SourceImage toSourceImage(const cv::Mat &src)
+{
+    GrayWarp::SourceImage image;
+    image.data = src.ptr<uint8_t>();
+    image.width = src.cols;
+    image.height = src.rows;
+    image.step = src.step;
+    return image;
+}
+
+GrayWarp::RemapTable toRemapTable(const PerspectiveMap &map)
+{
+    GrayWarp::RemapTable table;
+    table.xy = map.map1.ptr<int16_t>();
+    table.xyStep = map.map1.step;
+    table.frac = map.map2.ptr<uint16_t>();
+    table.fracStep = map.map2.step;
+    table.width = map.map1.cols;
+    table.height = map.map1.rows;
+    return table;
+}
+}
+
+void warpToGray(const cv::Mat &src, cv::Mat &gray, const GaugeParams &params,
+                const std::shared_ptr<const PerspectiveMap> &pinnedMap)
+{
+    // 灰度原图只需透视变换
+    if (src.type() == CV_8UC1)
+    {
+        applyPerspectiveTransform(src, gray, params, pinnedMap);
+        return;
+    }
+    if (!fusedWarpSupported(src))
+    {
+        // 中间的透视图放在每个线程复用的缓冲区中，连续帧不再分配
+        thread_local cv::Mat perspective;
+        applyPerspectiveTransform(src, perspective, params, pinnedMap);
+        convertToGray(perspective, gray);
+        return;
+    }
+
+    const cv::Size outputSize(params.outputWidth, params.outputHeight);
+    auto map = perspectiveMap(params, pinnedMap);
+    if (params.sourcePoints.size() != 4 || map->map1.empty())
+    {
+        gray.release();
+        return;
+    }
+
+    gray.create(outputSize, CV_8UC1);
+    GrayWarp::warpToGray(toSourceImage(src), toRemapTable(*map), gray.ptr<uint8_t>(), gray.step);
+}
+
+void warpToBlurred(const cv::Mat &src, cv::Mat &blurred, const GaugeParams &params,
+                   const std::shared_ptr<const PerspectiveMap> &pinnedMap)
+{
+    if (!fusedWarpSupported(src) || params.blurMode != BlurEngine::ExactGaussian)
+    {
+        thread_local cv::Mat gray;
+        warpToGray(src, gray, params, pinnedMap);
+        applyGaussianBlur(gray, blurred, params);
+        return;
+    }
+
+    const cv::Size outputSize(params.outputWidth, params.outputHeight);
+    auto map = perspectiveMap(params, pinnedMap);
+    if (params.sourcePoints.size() != 4 || map->map1.empty())
+    {
+        blurred.release();
+        return;
+    }
+
+    // 与 cv::GaussianBlur 一致：sigmaY 为 0 时取 sigmaX
+    auto kx = BlurEngine::gaussianKernel(GaugeBlurSize, params.sigmaX);
+    auto ky = BlurEngine::gaussianKernel(GaugeBlurSize, params.sigmaY > 0 ? params.sigmaY : params.sigmaX);
+
+    blurred.create(outputSize, CV_8UC1);
+    GrayWarp::warpToGrayBlurred(toSourceImage(src), toRemapTable(*map), *kx, *ky,
+                                blurred.ptr<uint8_t>(), blurred.step);
+}
+
+
+// --------------------边缘检测--------------------
+void detectEdges(const cv::Mat &blurred, cv::Mat &edges, const GaugeParams &params,
+                 EdgeGradients *gradients)
+{
+    // 输出用 create 分配，已有同尺寸的缓冲区（处理链的临时缓冲区）时直接复用；算不出梯度时清空
+    if (blurred.empty() || blurred.type() != CV_8UC1)
+    {
+        if (gradients)
+        {
+            *gradients = EdgeGradients();
+        }
+        if (blurred.empty())
+        {
+            edges.release();
+        }
+        else
+        {
+            cv::Canny(blurred, edges, params.cannyThreshold1, params.cannyThreshold2);
+        }
+        return;
+    }
+
+    ParallelCanny::Image src;
+    src.data = blurred.ptr<uint8_t>();
+    src.width = blurred.cols;
+    src.height = blurred.rows;
+    src.step = blurred.step;
+
+    edges.create(blurred.size(), CV_8UC1);
+    ParallelCanny::Output out;
+    out.edges = edges.ptr<uint8_t>();
+    out.edgesStep = edges.step;
+    if (gradients)
+    {
+        gradients->dx.create(blurred.size(), CV_16SC1);
+        gradients->dy.create(blurred.size(), CV_16SC1);
+        gradients->magnitude.create(blurred.size(), CV_16SC1);
+        out.dx = gradients->dx.ptr<int16_t>();
+        out.dxStep = gradients->dx.step;
+        out.dy = gradients->dy.ptr<int16_t>();
+        out.dyStep = gradients->dy.step;
+        out.magnitude = gradients->magnitude.ptr<int16_t>();
+        out.magnitudeStep = gradients->magnitude.step;
+    }
+
+    // 分块交给 OpenCV 的线程池；批处理时每个线程已设为单线程，这里自然退化为串行
+    const int tiles = ParallelCanny::tileCount(blurred.rows, std::max(1, cv::getNumThreads()) * 2);
+    ParallelCanny::detect(src, params.cannyThreshold1, params.cannyThreshold2, out, tiles,
+                          [](int count, const std::function<void(int)> &body) {
+        cv::parallel_for_(cv::Range(0, count), [&](const cv::Range &range) {
+            for (int i = range.start; i < range.end; ++i)
+            {
+                body(i);
+            }
+        });
+    });
+}
+
+void acquireEdgeBuffers(FramePool &pool, const cv::Size &size, cv::Mat &edges, EdgeGradients &gradients)
+{
+    edges = pool.acquire(size, CV_8UC1);
+    gradients.dx = pool.acquire(size, CV_16SC1);
+    gradients.dy = pool.acquire(size, CV_16SC1);
+    gradients.magnitude = pool.acquire(size, CV_16SC1);
+}
+
+
+// --------------------霍夫圆检测--------------------
+void detectCircles(const cv::Mat &blurred, const cv::Mat &edges, const EdgeGradients &gradients,
+                   const GaugeParams &params, GaugeResult &result)
+{
+    result.circleFound = false;
+    result.circle = cv::Vec3f();
+    result.circleSupport = 0.0;
+    result.circleScore = 0.0;
+    result.circleLocked = false;
+    if (edges.empty())
+    {
+        return;
+    }
+
+    CircleDetector::Detection detection;
+    if (params.circlePyramidLevels > 0 && !blurred.empty())
+    {
+        detection = CircleDetector::pyramid(blurred, edges, gradients, params);
+    }
+    else
+    {
+        detection = CircleDetector::detect(params.circleMethod, edges, gradients,
+                                           params.minRadius, params.maxRadius);
+    }
+
+    if (detection.found)
+    {
+        result.circleFound = true;
+        result.circle = detection.circle;
+        result.circleSupport = circleEdgeSupport(edges, result.circle);
+        result.circleScore = std::isnan(detection.score) ? result.circleSupport : detection.score;
+    }
+}
+
+
+// --------------------霍夫直线检测--------------------
+namespace
+{
+// 圆心出发、角度为 angle（度）的径向线段，[innerRadius, outerRadius] 为到圆心的距离，坐标相对于 ROI
+cv::Vec4i radialSegment(const GaugeResult &result, double angle, double innerRadius, double outerRadius)
+{
+    const double a = angle * CV_PI / 180;
+    const double c = std::cos(a);
+    const double s = -std::sin(a);
+    const cv::Rect &roi = result.pointerRoi;
+    return cv::Vec4i(cvRound(result.circle[0] + innerRadius * c) - roi.x,
+                     cvRound(result.circle[1] + innerRadius * s) - roi.y,
+                     cvRound(result.circle[0] + outerRadius * c) - roi.x,
+                     cvRound(result.circle[1] + outerRadius * s) - roi.y);
+}
+}
+
+void detectLines(const cv::Mat &edges, const EdgeGradients &gradients, const GaugeParams &params,
+                 GaugeResult &result, double searchAngle, double searchHalfWidth)
+{
+    result.pointerFound = false;
+    result.pointerLine = cv::Vec4i();
+    result.pointerRoi = cv::Rect();
+    result.pointerAngle = std::numeric_limits<double>::quiet_NaN();
+    result.pointerScore = 0.0;
+    if (edges.empty() || !result.circleFound)
+    {
+        return;
+    }
+
+    const int x = cvRound(result.circle[0]);
+    const int y = cvRound(result.circle[1]);
+    const int radius = cvRound(result.circle[2]);
+
+    // 创建ROI区域
+    cv::Rect roi(x - radius, y - radius, radius * 2, radius * 2);
+    roi = roi & cv::Rect(0, 0, edges.cols, edges.rows);
+    if (roi.width <= 0 || roi.height <= 0)
+    {
+        return;
+    }
+    result.pointerRoi = roi;
+
+    if (params.pointerMethod == PointerDetector::PolarMethod)
+    {
+        const PointerDetector::Detection detection = !std::isnan(searchAngle) && searchHalfWidth < 180.0
+                ? PointerDetector::polarWindow(edges, gradients, result.circle, params.minLineLength,
+                                               searchAngle, searchHalfWidth)
+                : PointerDetector::polar(edges, gradients, result.circle, params.minLineLength);
+        if (detection.found)
+        {
+            // 线段只用于绘制，角度直接用检测器的亚度级结果
+            result.pointerLine = radialSegment(result, detection.angle, detection.innerRadius, detection.outerRadius);
+            result.pointerAngle = detection.angle;
+            result.pointerScore = detection.score;
+            result.pointerFound = true;
+        }
+        return;
+    }
+
+    // 指针沿径向，其边缘的梯度垂直于径向；梯度接近径向的边缘（表盘外圈、刻度圆弧）先去掉
+    cv::Mat roiEdges = edges(roi);
+    if (!gradients.empty() && gradients.dx.size() == edges.size())
+    {
+        // 过滤后的副本和检出的直线放在每个线程复用的缓冲区中，连续帧不再重新分配
+        thread_local cv::Mat filtered;
+        roiEdges.copyTo(filtered);
+        roiEdges = filtered;
+        for (int ry = 0; ry < roi.height; ++ry)
+        {
+            uchar *e = roiEdges.ptr<uchar>(ry);
+            const int16_t *gx = gradients.dx.ptr<int16_t>(roi.y + ry) + roi.x;
+            const int16_t *gy = gradients.dy.ptr<int16_t>(roi.y + ry) + roi.x;
+            for (int rx = 0; rx < roi.width; ++rx)
+            {
+                if (!e[rx])
+                {
+                    continue;
+                }
+                const float vx = roi.x + rx - result.circle[0];
+                const float vy = roi.y + ry - result.circle[1];
+                const float radial = std::abs(vx * gx[rx] + vy * gy[rx]);
+                const float norm = std::sqrt((vx * vx + vy * vy) * (float(gx[rx]) * gx[rx] + float(gy[rx]) * gy[rx]));
+                if (radial > RadialEdgeCosine * norm)
+                {
+                    e[rx] = 0;
+                }
+            }
+        }
+    }
+
+    // 检测直线（指针）
+    thread_local std::vector<cv::Vec4i> lines;
+    lines.clear();
+    cv::HoughLinesP(roiEdges, lines, 1, CV_PI/180, 30, params.minLineLength, params.maxLineGap);
+
+    // 找到最长的直线作为指针，指针长度接近半径时置信度取满分
+    double maxLength = 0;
+    for (const auto &line : lines)
+    {
+        double length = cv::norm(cv::Point2f(line[0], line[1]) - cv::Point2f(line[2], line[3]));
+        if (length > maxLength)
+        {
+            maxLength = length;
+            result.pointerLine = line;
+            result.pointerFound = true;
+        }
+    }
+    result.pointerScore = std::min(1.0, maxLength / std::max(1, radius));
+}
+
+void setPointerAngle(GaugeResult &result, double angle)
+{
+    if (!result.pointerFound)
+    {
+        return;
+    }
+
+    const cv::Point2f center(result.circle[0] - result.pointerRoi.x, result.circle[1] - result.pointerRoi.y);
+    const double d1 = cv::norm(cv::Point2f(result.pointerLine[0], result.pointerLine[1]) - center);
+    const double d2 = cv::norm(cv::Point2f(result.pointerLine[2], result.pointerLine[3]) - center);
+    result.pointerLine = radialSegment(result, angle, std::min(d1, d2), std::max(d1, d2));
+    result.pointerAngle = angle;
+}
+
+
+// --------------------仪表分析--------------------
+void analyzeGauge(const GaugeParams &params, GaugeResult &result)
+{
+    if (!result.pointerFound)
+    {
+        result.angle = 0.0;
+        result.reading = std::numeric_limits<double>::quiet_NaN();
+        result.confidence = 0.0;
+        return;
+    }
+
+    // 计算指针角度（相对于圆心，ROI内的相对坐标）
+    cv::Point2f center(result.circle[0] - result.pointerRoi.x,
+                       result.circle[1] - result.pointerRoi.y);
+    cv::Point2f p1(result.pointerLine[0], result.pointerLine[1]);
+    cv::Point2f p2(result.pointerLine[2], result.pointerLine[3]);
+
+    double angle = result.pointerAngle;
+    if (std::isnan(angle))
+    {
+        // 确定哪个端点更接近圆心
+        double dist1 = cv::norm(p1 - center);
+        double dist2 = cv::norm(p2 - center);
+        cv::Point2f pointerTip = (dist1 < dist2) ? p2 : p1;
+
+        // 计算角度（0-360度，0点在右侧）
+        angle = std::atan2(center.y - pointerTip.y, pointerTip.x - center.x) * 180 / CV_PI;
+        if (angle < 0) angle += 360;
+    }
+
+    result.angle = angle;
+    result.reading = params.angleTable.empty()
+            ? calculateReading(angle, params.gaugeMinValue, params.gaugeMaxValue)
+            : readingFromTable(angle, params.angleTable);
+
+    // 极坐标方法的线段只覆盖环带（0.15R-0.85R），不能按长度与半径之比计分，由检测方法各自给出指针置信度
+    result.confidence = result.pointerScore * result.circleScore;
+}
+
+double calculateReading(double angle, double minValue, double maxValue)
+{
+    // 假设0度在右侧，270度在顶部（模拟实际仪表）
+    // 调整角度起始位置
+    double adjustedAngle = std::fmod(angle + 270, 360);
+
+    // 将角度转换为读数
+    double range = maxValue - minValue;
+    return (adjustedAngle / 360.0) * range + minValue;
+}
+
+double readingFromTable(double angle, const std::vector<cv::Point2d> &table)
+{
+    if (table.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (table.size() == 1)
+    {
+        return table[0].y;
+    }
+
+    // 把角度平移整圈，落到表的角度范围内；刻度方向可以是顺时针（角度递减）或逆时针
+    const double first = table.front().x;
+    const double last = table.back().x;
+    const double low = std::min(first, last);
+    const double high = std::max(first, last);
+    double a = low + std::fmod(std::fmod(angle - low, 360.0) + 360.0, 360.0);
+    if (a > high)
+    {
+        // 落在表外的空白区，取角度上更近的端点
+        const double toHigh = a - high;
+        const double toLow = low + 360.0 - a;
+        return (toHigh <= toLow) == (last >= first) ? table.back().y : table.front().y;
+    }
+
+    for (size_t i = 1; i < table.size(); ++i)
+    {
+        const cv::Point2d &p0 = table[i - 1];
+        const cv::Point2d &p1 = table[i];
+        if ((a - p0.x) * (a - p1.x) <= 0.0)
+        {
+            const double span = p1.x - p0.x;
+            return span == 0.0 ? p0.y : p0.y + (a - p0.x) / span * (p1.y - p0.y);
+        }
+    }
+    return table.back().y;
+}
+
+std::vector<cv::Point2d> angleTable(const GaugeParams &params)
+{
+    if (!params.angleTable.empty())
+    {
+        return params.angleTable;
+    }
+    // calculateReading：角度 90 度（顶部）为最小值，逆时针转一整圈到最大值
+    return { cv::Point2d(90.0, params.gaugeMinValue), cv::Point2d(450.0, params.gaugeMaxValue) };
+}
+
+double circleEdgeSupport(const cv::Mat &edges, const cv::Vec3f &circle)
+{
+    if (edges.empty() || circle[2] <= 0)
+    {
+        return 0.0;
+    }
+
+    // 落在图像外的采样点按不支持计算
+    const int samples = 360;
+    int supported = 0;
+    for (int i = 0; i < samples; ++i)
+    {
+        const double a = 2 * CV_PI * i / samples;
+        const int px = cvRound(circle[0] + circle[2] * std::cos(a));
+        const int py = cvRound(circle[1] + circle[2] * std::sin(a));
+        if (px < 1 || py < 1 || px >= edges.cols - 1 || py >= edges.rows - 1)
+        {
+            continue;
+        }
+
+        // 允许 1 像素的位置误差
+        bool hit = false;
+        for (int dy = -1; dy <= 1 && !hit; ++dy)
+        {
+            const uchar *row = edges.ptr<uchar>(py + dy);
+            hit = row[px - 1] || row[px] || row[px + 1];
+        }
+        if (hit) ++supported;
+    }
+
+    return double(supported) / samples;
+}
+
+
+// --------------------完整处理链--------------------
+GaugeResult process(const cv::Mat &image, const GaugeParams &params, GaugeFrame *frame)
+{
+    GaugeFrame local;
+    GaugeFrame &f = frame ? *frame : local;
+    f.timings.begin("process");
+
+    if (frame)
+    {
+        {
+            ScopedTimer timer("perspective", &f.timings);
+            applyPerspectiveTransform(image, f.perspective, params);
+        }
+        {
+            ScopedTimer timer("gray", &f.timings);
+            convertToGray(f.perspective, f.gray);
+        }
+        ScopedTimer timer("blur", &f.timings);
+        applyGaussianBlur(f.gray, f.blurred, params);
+    }
+    else
+    {
+        // 只要读数时，透视变换、灰度化和模糊一遍完成
+        ScopedTimer timer("warpToBlurred", &f.timings);
+        warpToBlurred(image, f.blurred, params);
+    }
+    {
+        ScopedTimer timer("edges", &f.timings);
+        detectEdges(f.blurred, f.edges, params, &f.gradients);
+    }
+
+    GaugeResult result;
+    {
+        ScopedTimer timer("circles", &f.timings);
+        detectCircles(f.blurred, f.edges, f.gradients, params, result);
+    }
+    {
+        ScopedTimer timer("lines", &f.timings);
+        detectLines(f.edges, f.gradients, params, result);
+    }
+    {
+        ScopedTimer timer("analyze", &f.timings);
+        analyzeGauge(params, result);
+    }
+
+    f.result = result;
+    f.timings.end();
+    return result;
+}
+
+
+// --------------------结果绘制--------------------
+namespace
+{
+// 底图转为彩色写入 image，image 已有相同尺寸的缓冲区时直接复用
+void toColor(const cv::Mat &base, cv::Mat &image)
+{
+    if (base.channels() == 1)
+    {
+        cv::cvtColor(base, image, cv::COLOR_GRAY2BGR);
+    }
+    else
+    {
+        base.copyTo(image);
+    }
+}
+
+void paintCircle(cv::Mat &image, const GaugeResult &result)
+{
+    if (result.circleFound)
+    {
+        cv::Point center(cvRound(result.circle[0]), cvRound(result.circle[1]));
+        cv::circle(image, center, cvRound(result.circle[2]), cv::Scalar(0, 0, 255), 2); // 绘制圆周
+        cv::circle(image, center, 3, cv::Scalar(0, 255, 0), -1); // 绘制圆心
+    }
+}
+
+void paintPointer(cv::Mat &image, const GaugeResult &result)
+{
+    if (result.pointerFound)
+    {
+        const cv::Rect &roi = result.pointerRoi;
+        cv::rectangle(image, roi, cv::Scalar(255, 255, 0), 2);
+
+        // 绘制直线（注意坐标转换）
+        cv::Point pt1(result.pointerLine[0] + roi.x, result.pointerLine[1] + roi.y);
+        cv::Point pt2(result.pointerLine[2] + roi.x, result.pointerLine[3] + roi.y);
+        cv::line(image, pt1, pt2, cv::Scalar(0, 0, 255), 2); // 红色，线宽2
+    }
+}
+
+cv::Mat colorBuffer(const cv::Mat &base, FramePool *pool)
+{
+    return pool ? pool->acquire(base.size(), base.channels() == 1 ? CV_8UC3 : base.type()) : cv::Mat();
+}
+}
+
+cv::Mat drawCircle(const cv::Mat &perspective, const GaugeResult &result)
+{
+    if (perspective.empty())
+    {
+        return cv::Mat();
+    }
+
+    cv::Mat image;
+    toColor(perspective, image);
+    paintCircle(image, result);
+    return image;
+}
+
+cv::Mat drawPointer(const cv::Mat &circleImage, const GaugeResult &result)
+{
+    if (circleImage.empty())
+    {
+        return cv::Mat();
+    }
+
+    cv::Mat image = circleImage.clone();
+    paintPointer(image, result);
+    return image;
+}
+
+void drawOverlays(const GaugeFrame &frame, bool circle, bool pointer, cv::Mat &circleImage, cv::Mat &lineImage,
+                  FramePool *pool)
+{
+    circleImage.release();
+    lineImage.release();
+    const cv::Mat &base = frame.overlayBase();
+    if ((!circle && !pointer) || base.empty())
+    {
+        return;
+    }
+
+    cv::Mat image = colorBuffer(base, pool);
+    toColor(base, image);
+    paintCircle(image, frame.result);
+    if (!circle)
+    {
+        // 只要指针图时直接画在圆形叠加图上，少复制一次整帧
+        paintPointer(image, frame.result);
+        lineImage = image;
+        return;
+    }
+
+    circleImage = image;
+    if (pointer)
+    {
+        lineImage = colorBuffer(base, pool);
+        image.copyTo(lineImage);
+        paintPointer(lineImage, frame.result);
+    }
+}
+
+}
@@ -0,0 +1,163 @@
+#ifndef GAUGECORE_H
+#define GAUGECORE_H
+
+#include "CircleDetector.h"
+#include "FramePool.h"
+#include "GaussianBlurEngine.h"
+#include "PointerDetector.h"
+#include "StageTimer.h"
+#include <opencv2/opencv.hpp>
+#include <limits>
+#include <memory>
+#include <vector>
+
+struct PerspectiveMap;
+
+// 仪表识别参数。作为不可变快照传入处理函数，多个线程可同时共享同一份参数
+struct GaugeParams
+{
+    // 透视变换
+    std::vector<cv::Point2f> sourcePoints = {
+        cv::Point2f(60, 41),   // 左上
+        cv::Point2f(621, 36),  // 右上
+        cv::Point2f(586, 528), // 右下
+        cv::Point2f(55, 582)   // 左下
+    };
+    int outputWidth = 612;
+    int outputHeight = 580;
+
+    // 高斯模糊
+    double sigmaX = 2.0;
+    double sigmaY = 2.0;
+    BlurEngine::Mode blurMode = BlurEngine::ExactGaussian;   // 实时调参时可切到 FastBox
+
+    // Canny边缘检测
+    int cannyThreshold1 = 50;
+    int cannyThreshold2 = 150;
+
+    // 霍夫圆检测
+    int minRadius = 281;
+    int maxRadius = 377;
+    CircleDetector::Method circleMethod = CircleDetector::GradientVoteMethod;
+    int circlePyramidLevels = 0;    // 大于 0 时先在 1/2^n 的图上检测再回原图精化，最多 3 层
+
+    // 霍夫直线检测
+    int rho = 1;
+    double theta = CV_PI / 180;
+    int threshold = 30;
+    int minLineLength = 50;
+    int maxLineGap = 150;
+    PointerDetector::Method pointerMethod = PointerDetector::PolarMethod;
+
+    // 仪表量程
+    double gaugeMinValue = 0.0;
+    double gaugeMaxValue = 15.0;
+    // 刻度表：(指针角度, 读数) 按刻度顺序排列，角度沿刻度方向连续展开（可超出 0-360）。
+    // 非空时按分段线性插值计算读数，代替上面的线性量程，用于刻度不均匀的表
+    std::vector<cv::Point2d> angleTable;
+};
+
+// 单次识别结果
+struct GaugeResult
+{
+    bool circleFound = false;
+    cv::Vec3f circle;           // 表盘圆心和半径（透视变换后坐标）
+    double circleSupport = 0.0; // 圆周边缘支持率，0-1
+    double circleScore = 0.0;   // 检测方法给出的置信度（如 RANSAC 内点覆盖的圆周比例），0-1；方法不提供时等于 circleSupport
+    bool circleLocked = false;  // 圆来自几何锁定，本帧只做了验证
+
+    bool pointerFound = false;
+    cv::Rect pointerRoi;        // 指针检测 ROI（透视变换后坐标）
+    cv::Vec4i pointerLine;      // 指针线段（ROI 内坐标）
+    double pointerAngle = std::numeric_limits<double>::quiet_NaN(); // 检测器直接给出的角度，NaN 时由 pointerLine 计算
+    double pointerScore = 0.0;  // 0-1，极坐标方法为环带内有指针边缘的半径比例，霍夫方法为线段长度与半径之比
+
+    double angle = 0.0;         // 指针角度，0-360 度，0 点在右侧
+    double reading = 0.0;       // 读数，未找到指针时为 NaN
+    double confidence = 0.0;    // 0-1，圆检测置信度与指针检测置信度之积（circleScore * pointerScore）
+
+    bool isValid() const { return circleFound && pointerFound; }
+};
+
+// 边缘检测时算出的 Sobel 梯度，后续阶段直接复用，不再重复计算
+struct EdgeGradients
+{
+    cv::Mat dx;         // CV_16SC1
+    cv::Mat dy;         // CV_16SC1
+    cv::Mat magnitude;  // CV_16SC1，|dx| + |dy|
+
+    bool empty() const { return magnitude.empty(); }
+};
+
+// 处理链各阶段的中间图像
+struct GaugeFrame
+{
+    cv::Mat perspective;
+    cv::Mat gray;
+    cv::Mat blurred;
+    cv::Mat edges;
+    EdgeGradients gradients;
+    GaugeResult result;
+    StageTimings timings;       // StageTrace 打开时记录各阶段耗时
+
+    // 绘制结果用的底图：有彩色透视图时用彩色图，否则用灰度图
+    const cv::Mat &overlayBase() const { return perspective.empty() ? gray : perspective; }
+};
+
+// 无状态的仪表识别核心：所有函数只依赖参数，可重入、可多线程并发调用
+namespace GaugeCore
+{
+// 高斯模糊核尺寸
+const int GaugeBlurSize = 9;
+
+// 处理链各阶段。透视变换的 map 为调用方按 params 取得并固定持有的映射表（多表模式下每块表一张），
+// 为空时按参数从 PerspectiveMapCache 查找
+void applyPerspectiveTransform(const cv::Mat &src, cv::Mat &dst, const GaugeParams &params,
+                               const std::shared_ptr<const PerspectiveMap> &map = nullptr);
+void convertToGray(const cv::Mat &src, cv::Mat &dst);
+void applyGaussianBlur(const cv::Mat &gray, cv::Mat &dst, const GaugeParams &params);
+
+// 融合阶段：直接从 BGR 原图采样得到灰度图（或模糊后的灰度图），不生成彩色透视变换结果。
+// 只有界面需要显示彩色透视图时才走上面的分步实现。直接解码为灰度的原图只做透视变换
+void warpToGray(const cv::Mat &src, cv::Mat &gray, const GaugeParams &params,
+                const std::shared_ptr<const PerspectiveMap> &map = nullptr);
+void warpToBlurred(const cv::Mat &src, cv::Mat &blurred, const GaugeParams &params,
+                   const std::shared_ptr<const PerspectiveMap> &map = nullptr);
+// 按行分块并行的 Canny；gradients 不为空时同时输出梯度
+void detectEdges(const cv::Mat &blurred, cv::Mat &edges, const GaugeParams &params,
+                 EdgeGradients *gradients = nullptr);
+// 从池中为边缘图和梯度取输出缓冲区，之后的 detectEdges 直接写入
+void acquireEdgeBuffers(FramePool &pool, const cv::Size &size, cv::Mat &edges, EdgeGradients &gradients);
+// 圆检测和指针检测共用边缘检测阶段的边缘图与梯度；gradients 为空时退回只用边缘图的方法
+// blurred 只在金字塔模式下使用
+void detectCircles(const cv::Mat &blurred, const cv::Mat &edges, const EdgeGradients &gradients,
+                   const GaugeParams &params, GaugeResult &result);
+// searchAngle 不为 NaN 时（只对 PolarMethod 有效）只在 searchAngle ± searchHalfWidth 度内找指针
+void detectLines(const cv::Mat &edges, const EdgeGradients &gradients, const GaugeParams &params,
+                 GaugeResult &result, double searchAngle = std::numeric_limits<double>::quiet_NaN(),
+                 double searchHalfWidth = 180.0);
+// 用平滑后的角度（度）代替检测到的角度：pointerLine 绕圆心转到该角度并保持径向范围，绘制的指针与读数一致
+void setPointerAngle(GaugeResult &result, double angle);
+void analyzeGauge(const GaugeParams &params, GaugeResult &result);
+
+double calculateReading(double angle, double minValue = 0.0, double maxValue = 1.0);
+// 按刻度表插值；表外的角度取最近端点的读数
+double readingFromTable(double angle, const std::vector<cv::Point2d> &table);
+// 当前参数对应的刻度表：有 angleTable 时直接返回，否则返回与线性量程等价的两点表
+std::vector<cv::Point2d> angleTable(const GaugeParams &params);
+
+// 圆周上有边缘像素支持的采样点比例（0-1）
+double circleEdgeSupport(const cv::Mat &edges, const cv::Vec3f &circle);
+
+// 完整处理链；frame 不为空时保留全部中间图像，为空时走融合路径只算需要的数据
+GaugeResult process(const cv::Mat &image, const GaugeParams &params, GaugeFrame *frame = nullptr);
+
+// 结果绘制（只在需要显示时调用），底图可以是彩色透视图或灰度图
+cv::Mat drawCircle(const cv::Mat &perspective, const GaugeResult &result);
+cv::Mat drawPointer(const cv::Mat &circleImage, const GaugeResult &result);
+// 只绘制需要的叠加图，不需要的一项输出为空；pool 不为空时叠加图从池中取缓冲区
+void drawOverlays(const GaugeFrame &frame, bool circle, bool pointer, cv::Mat &circleImage, cv::Mat &lineImage,
+                  FramePool *pool = nullptr);
+}
+
+#endif // GAUGECORE_H
@@ -0,0 +1,305 @@
+#include "GaugePipeline.h"
+
+GaugePipeline::GaugePipeline(size_t cacheCapacity)
+    : m_sourceId(0)
+    , m_retainedOutputs(AllOutputs)
+    , m_pool(cacheCapacity * 8 + 8)
+    , m_lastComputedStages(0)
+    , m_lastRunCancelled(false)
+    , m_colorWarpEnabled(true)
+    , m_perspectiveCache(cacheCapacity)
+    , m_grayCache(cacheCapacity)
+    , m_blurCache(cacheCapacity)
+    , m_edgesCache(cacheCapacity)
+    , m_circlesCache(cacheCapacity)
+    , m_linesCache(cacheCapacity)
+{
+}
+
+void GaugePipeline::setSource(const cv::Mat &image, uint64_t sourceId)
+{
+    if (sourceId != m_sourceId)
+    {
+        clear();
+    }
+    m_source = image;
+    m_sourceId = sourceId;
+}
+
+void GaugePipeline::clear()
+{
+    m_perspectiveCache.clear();
+    m_grayCache.clear();
+    m_blurCache.clear();
+    m_edgesCache.clear();
+    m_circlesCache.clear();
+    m_linesCache.clear();
+}
+
+void GaugePipeline::setRetainedOutputs(int outputs)
+{
+    outputs &= AllOutputs;
+    // 取消订阅的输出立即从缓存和池中释放
+    const int dropped = m_retainedOutputs & ~outputs;
+    if (dropped & PerspectiveOutput) m_perspectiveCache.clear();
+    if (dropped & GrayOutput) m_grayCache.clear();
+    if (dropped & BlurredOutput) m_blurCache.clear();
+    if (dropped & EdgesOutput) m_edgesCache.clear();
+    if (dropped)
+    {
+        m_pool.trim();
+    }
+    m_retainedOutputs = outputs;
+}
+
+MemoryUsage GaugePipeline::memoryUsage(MemoryCounter &counter) const
+{
+    MemoryUsage usage;
+    usage.source = counter.add(m_source);
+
+    auto addEdges = [&counter](const EdgesEntry &entry) {
+        return counter.add(entry.edges) + counter.add(entry.gradients.dx)
+                + counter.add(entry.gradients.dy) + counter.add(entry.gradients.magnitude);
+    };
+    auto addMat = [&](const cv::Mat &mat) { usage.cache += counter.add(mat); };
+    m_perspectiveCache.forEach(addMat);
+    m_grayCache.forEach(addMat);
+    m_blurCache.forEach(addMat);
+    m_edgesCache.forEach([&](const EdgesEntry &entry) { usage.cache += addEdges(entry); });
+
+    usage.scratch = m_pool.bytes(counter);
+    return usage;
+}
+
+MemoryUsage GaugePipeline::memoryUsage() const
+{
+    MemoryCounter counter;
+    return memoryUsage(counter);
+}
+
+GaugeResult GaugePipeline::run(const GaugeParams &params, GaugeFrame &frame,
+                               const std::function<bool()> &cancelled)
+{
+    m_lastComputedStages = 0;
+    m_lastRunCancelled = false;
+    if (m_source.empty())
+    {
+        frame = GaugeFrame();
+        return frame.result;
+    }
+    frame.timings.begin();
+
+    auto checkCancelled = [&]() {
+        if (cancelled && cancelled())
+        {
+            m_lastRunCancelled = true;
+        }
+        return m_lastRunCancelled;
+    };
+
+    // 彩色透视图只在订阅时生成，否则灰度图直接由融合内核从原图得到
+    const bool colorWarp = m_colorWarpEnabled && retains(PerspectiveOutput);
+
+    StageKey perspectiveKey(m_sourceId);
+    for (const auto &pt : params.sourcePoints)
+    {
+        perspectiveKey.add(pt.x).add(pt.y);
+    }
+    perspectiveKey.add(params.outputWidth).add(params.outputHeight);
+    StageKey grayKey(perspectiveKey.value());
+    grayKey.add(colorWarp);
+    StageKey blurKey(grayKey.value());
+    blurKey.add(params.sigmaX).add(params.sigmaY).add(int(params.blurMode));
+    StageKey edgesKey(blurKey.value());
+    edgesKey.add(params.cannyThreshold1).add(params.cannyThreshold2);
+    StageKey circlesKey(edgesKey.value());
+    circlesKey.add(params.minRadius).add(params.maxRadius).add(int(params.circleMethod))
+            .add(params.circlePyramidLevels);
+    // rho/theta/threshold 目前在检测中固定为 1、CV_PI/180、30，不参与键计算
+    StageKey linesKey(circlesKey.value());
+    linesKey.add(params.minLineLength).add(params.maxLineGap).add(int(params.pointerMethod));
+
+    // 先查全部缓存（未订阅的图像不进缓存，不必查），再从后往前推出要计算的阶段：
+    // 订阅的输出未命中时计算；未订阅的输出只在下游有阶段要计算时才算到临时缓冲区
+    const cv::Mat *perspective = colorWarp ? m_perspectiveCache.find(perspectiveKey.value()) : nullptr;
+    const cv::Mat *gray = retains(GrayOutput) ? m_grayCache.find(grayKey.value()) : nullptr;
+    const cv::Mat *blurred = retains(BlurredOutput) ? m_blurCache.find(blurKey.value()) : nullptr;
+    const EdgesEntry *edges = retains(EdgesOutput) ? m_edgesCache.find(edgesKey.value()) : nullptr;
+    const GaugeResult *cachedCircles = m_circlesCache.find(circlesKey.value());
+    const GaugeResult *cachedLines = m_linesCache.find(linesKey.value());
+
+    const bool computeLines = !cachedLines;
+    const bool computeCircles = !cachedCircles;
+    const bool computeEdges = !edges && (retains(EdgesOutput) || computeCircles || computeLines);
+    const bool computeBlur = !blurred && (retains(BlurredOutput) || computeEdges || computeCircles);
+    const bool computeGray = !gray && (retains(GrayOutput) || computeBlur);
+
+    // 每个阶段的输出写入从池中取出的空闲缓冲区，不会覆盖缓存中或调用方仍持有的数据；
+    // 未订阅的输出只在本次运行中由局部变量持有，运行结束即回到池中
+    const cv::Size outputSize(params.outputWidth, params.outputHeight);
+    cv::Mat grayBuffer;
+    cv::Mat blurBuffer;
+    EdgesEntry edgesBuffer;
+
+    // --------------------透视变换--------------------
+    if (perspective)
+    {
+        frame.timings.markCached("perspective");
+    }
+    else if (colorWarp)
+    {
+        ScopedTimer timer("perspective", &frame.timings);
+        cv::Mat out = m_pool.acquire(outputSize, m_source.type());
+        GaugeCore::applyPerspectiveTransform(m_source, out, params);
+        perspective = &m_perspectiveCache.insert(perspectiveKey.value(), out);
+        ++m_lastComputedStages;
+    }
+    frame.perspective = perspective ? *perspective : cv::Mat();
+
+    // --------------------灰度--------------------
+    if (checkCancelled()) return GaugeResult();
+    if (gray)
+    {
+        frame.timings.markCached("gray");
+    }
+    else if (computeGray)
+    {
+        ScopedTimer timer("gray", &frame.timings);
+        grayBuffer = m_pool.acquire(outputSize, CV_8UC1);
+        if (colorWarp)
+        {
+            GaugeCore::convertToGray(*perspective, grayBuffer);
+        }
+        else
+        {
+            GaugeCore::warpToGray(m_source, grayBuffer, params);
+        }
+        gray = retains(GrayOutput) ? &m_grayCache.insert(grayKey.value(), grayBuffer) : &grayBuffer;
+        ++m_lastComputedStages;
+    }
+    frame.gray = gray && retains(GrayOutput) ? *gray : cv::Mat();
+
+    // --------------------高斯模糊--------------------
+    if (checkCancelled()) return GaugeResult();
+    if (blurred)
+    {
+        frame.timings.markCached("blur");
+    }
+    else if (computeBlur)
+    {
+        ScopedTimer timer("blur", &frame.timings);
+        blurBuffer = m_pool.acquire(outputSize, CV_8UC1);
+        GaugeCore::applyGaussianBlur(*gray, blurBuffer, params);
+        blurred = retains(BlurredOutput) ? &m_blurCache.insert(blurKey.value(), blurBuffer) : &blurBuffer;
+        ++m_lastComputedStages;
+    }
+    frame.blurred = blurred && retains(BlurredOutput) ? *blurred : cv::Mat();
+
+    // --------------------边缘检测--------------------
+    if (checkCancelled()) return GaugeResult();
+    if (edges)
+    {
+        frame.timings.markCached("edges");
+    }
+    else if (computeEdges)
+    {
+        ScopedTimer timer("edges", &frame.timings);
+        GaugeCore::acquireEdgeBuffers(m_pool, outputSize, edgesBuffer.edges, edgesBuffer.gradients);
+        GaugeCore::detectEdges(*blurred, edgesBuffer.edges, params, &edgesBuffer.gradients);
+        edges = retains(EdgesOutput) ? &m_edgesCache.insert(edgesKey.value(), edgesBuffer) : &edgesBuffer;
+        ++m_lastComputedStages;
+    }
+    if (edges && retains(EdgesOutput))
+    {
+        frame.edges = edges->edges;
+        frame.gradients = edges->gradients;
+    }
+    else
+    {
+        frame.edges.release();
+        frame.gradients = EdgeGradients();
+    }
+
+    // --------------------霍夫圆检测--------------------
+    if (checkCancelled()) return GaugeResult();
+    GaugeResult result;
+    if (cachedCircles)
+    {
+        result = *cachedCircles;
+        frame.timings.markCached("circles");
+    }
+    else
+    {
+        ScopedTimer timer("circles", &frame.timings);
+        m_geometryLock.detectCircles(*blurred, edges->edges, edges->gradients, params, result);
+        m_circlesCache.insert(circlesKey.value(), result);
+        ++m_lastComputedStages;
+    }
+
+    // --------------------霍夫直线检测--------------------
+    if (checkCancelled()) return GaugeResult();
+    if (cachedLines)
+    {
+        result = *cachedLines;
+        frame.timings.markCached("lines");
+    }
+    else
+    {
+        ScopedTimer timer("lines", &frame.timings);
+        m_needleTracker.detectLines(edges->edges, edges->gradients, params, result);
+        m_linesCache.insert(linesKey.value(), result);
+        ++m_lastComputedStages;
+    }
+
+    // 仪表分析只是几次浮点运算，每次都重新计算
+    {
+        ScopedTimer timer("analyze", &frame.timings);
+        GaugeCore::analyzeGauge(params, result);
+    }
+
+    frame.result = result;
+    frame.timings.end();
+    return result;
+}
+
+uint64_t GaugePipeline::hits(Stage stage) const
+{
+    switch (stage)
+    {
+    case PerspectiveStage: return m_perspectiveCache.hits();
+    case GrayStage: return m_grayCache.hits();
+    case BlurStage: return m_blurCache.hits();
+    case EdgesStage: return m_edgesCache.hits();
+    case CirclesStage: return m_circlesCache.hits();
+    case LinesStage: return m_linesCache.hits();
+    default: return 0;
+    }
+}
+
+uint64_t GaugePipeline::misses(Stage stage) const
+{
+    switch (stage)
+    {
+    case PerspectiveStage: return m_perspectiveCache.misses();
+    case GrayStage: return m_grayCache.misses();
+    case BlurStage: return m_blurCache.misses();
+    case EdgesStage: return m_edgesCache.misses();
+    case CirclesStage: return m_circlesCache.misses();
+    case LinesStage: return m_linesCache.misses();
+    default: return 0;
+    }
+}
+
+const char *GaugePipeline::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case PerspectiveStage: return "perspective";
+    case GrayStage: return "gray";
+    case BlurStage: return "blur";
+    case EdgesStage: return "edges";
+    case CirclesStage: return "circles";
+    case LinesStage: return "lines";
+    default: return "unknown";
+    }
+}
@@ -0,0 +1,120 @@
+#ifndef GAUGEPIPELINE_H
+#define GAUGEPIPELINE_H
+
+#include "GaugeCore.h"
+#include "GeometryLock.h"
+#include "MemoryUsage.h"
+#include "NeedleTracker.h"
+#include "StageCache.h"
+#include <functional>
+
+// 增量处理链：每个阶段以“上游键 + 本阶段参数”的散列为键缓存输出，
+// 参数变化时只重新计算真正失效的阶段，参数调回旧值时直接命中缓存
+class GaugePipeline
+{
+public:
+    enum Stage
+    {
+        PerspectiveStage,
+        GrayStage,
+        BlurStage,
+        EdgesStage,
+        CirclesStage,
+        LinesStage,
+        StageCount
+    };
+
+    // 可订阅的中间输出，按位组合
+    enum Output
+    {
+        NoOutputs = 0,
+        PerspectiveOutput = 1 << PerspectiveStage,
+        GrayOutput = 1 << GrayStage,
+        BlurredOutput = 1 << BlurStage,
+        EdgesOutput = 1 << EdgesStage,      // 边缘图和梯度
+        AllOutputs = PerspectiveOutput | GrayOutput | BlurredOutput | EdgesOutput
+    };
+
+    explicit GaugePipeline(size_t cacheCapacity = 8);
+
+    // 设置输入图像；sourceId 需唯一标识图像内容，换图时会清空缓存
+    void setSource(const cv::Mat &image, uint64_t sourceId);
+    const cv::Mat &source() const { return m_source; }
+    bool hasSource() const { return !m_source.empty(); }
+
+    // 运行处理链，frame 中得到订阅的各阶段输出（与缓存共享数据，调用方不得修改）。
+    // cancelled 在每个阶段开始前检查，返回 true 时放弃本次运行，已算完的阶段仍会留在缓存中
+    GaugeResult run(const GaugeParams &params, GaugeFrame &frame,
+                    const std::function<bool()> &cancelled = std::function<bool()>());
+    bool lastRunCancelled() const { return m_lastRunCancelled; }
+
+    void clear();
+
+    // 是否生成彩色透视变换结果。关闭后灰度图直接由融合内核从原图得到，frame.perspective 为空
+    // 只在订阅了 PerspectiveOutput 时生效
+    void setColorWarpEnabled(bool enabled) { m_colorWarpEnabled = enabled; }
+    bool isColorWarpEnabled() const { return m_colorWarpEnabled; }
+
+    // 中间结果的保留策略：订阅的输出进入阶段缓存并在 frame 中给出；未订阅的输出不缓存，
+    // 只在下游阶段需要重新计算时算到临时缓冲区，frame 中为空。
+    // 圆和指针的检测结果总是缓存。默认订阅全部输出；只要读数时设为 NoOutputs
+    void setRetainedOutputs(int outputs);
+    int retainedOutputs() const { return m_retainedOutputs; }
+
+    // 各阶段的输出缓冲区（包括进入缓存的）都从池中取，缓存淘汰或换图后回到池中复用，
+    // 同尺寸的连续帧预热后不再分配内存
+    const FramePool &pool() const { return m_pool; }
+
+    // 输入图像、阶段缓存和池中其余缓冲区占用的内存，共享数据的 Mat 经 counter 去重
+    MemoryUsage memoryUsage(MemoryCounter &counter) const;
+    MemoryUsage memoryUsage() const;
+
+    // 几何锁定：换图（新 sourceId）后圆检测阶段先验证锁定的圆，不通过才重新检测。
+    // 锁定状态不随 clear() 清除
+    void setGeometryLockEnabled(bool enabled) { m_geometryLock.setEnabled(enabled); }
+    bool isGeometryLockEnabled() const { return m_geometryLock.isEnabled(); }
+    GeometryLock &geometryLock() { return m_geometryLock; }
+    const GeometryLock &geometryLock() const { return m_geometryLock; }
+
+    // 指针跟踪：连续帧只在预测角附近找指针，读数经过滤波。同样不随 clear() 清除
+    void setNeedleTrackingEnabled(bool enabled) { m_needleTracker.setEnabled(enabled); }
+    bool isNeedleTrackingEnabled() const { return m_needleTracker.isEnabled(); }
+    NeedleTracker &needleTracker() { return m_needleTracker; }
+    const NeedleTracker &needleTracker() const { return m_needleTracker; }
+
+    // 最近一次 run 中实际重新计算的阶段数
+    int lastComputedStages() const { return m_lastComputedStages; }
+    uint64_t hits(Stage stage) const;
+    uint64_t misses(Stage stage) const;
+
+    static const char *stageName(Stage stage);
+
+private:
+    // 边缘图与同一次计算得到的梯度一起缓存
+    struct EdgesEntry
+    {
+        cv::Mat edges;
+        EdgeGradients gradients;
+    };
+
+    bool retains(Output output) const { return (m_retainedOutputs & output) != 0; }
+
+    cv::Mat m_source;
+    uint64_t m_sourceId;
+    int m_retainedOutputs;
+    FramePool m_pool;
+    int m_lastComputedStages;
+    bool m_lastRunCancelled;
+    bool m_colorWarpEnabled;
+    GeometryLock m_geometryLock;
+    NeedleTracker m_needleTracker;
+
+    StageCache<cv::Mat> m_perspectiveCache;
+    StageCache<cv::Mat> m_grayCache;
+    StageCache<cv::Mat> m_blurCache;
+    StageCache<EdgesEntry> m_edgesCache;
+    StageCache<GaugeResult> m_circlesCache;
+    StageCache<GaugeResult> m_linesCache;
+};
+
+#endif // GAUGEPIPELINE_H
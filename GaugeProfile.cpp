@@ -0,0 +1,356 @@
+#include "GaugeProfile.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cstring>
+
+namespace
+{
+const int ProfileVersion = 1;
+
+// 映射表每边的上限，超出视为文件损坏，不按文件中的尺寸分配内存
+const int MaxMapSide = 16384;
+
+// 枚举按名称保存，调整枚举顺序不影响已有文件
+const char *const BlurModeNames[] = { "exact", "box" };
+const char *const CircleMethodNames[] = { "hough", "gradient", "ransac" };
+const char *const PointerMethodNames[] = { "hough", "polar" };
+
+template <size_t N>
+QString enumName(const char *const (&names)[N], int value)
+{
+    return (value >= 0 && value < int(N)) ? QString(names[value]) : QString();
+}
+
+template <size_t N>
+int enumValue(const char *const (&names)[N], const QJsonValue &value, int defaultValue)
+{
+    const QString name = value.toString();
+    for (size_t i = 0; i < N; ++i)
+    {
+        if (name == names[i])
+        {
+            return int(i);
+        }
+    }
+    return defaultValue;
+}
+
+QJsonArray pointArray(double x, double y)
+{
+    return QJsonArray{ x, y };
+}
+
+QJsonValue matToJson(const cv::Mat &mat)
+{
+    const cv::Mat data = mat.isContinuous() ? mat : mat.clone();
+    const QByteArray raw(reinterpret_cast<const char *>(data.data), int(data.total() * data.elemSize()));
+    return QString::fromLatin1(qCompress(raw).toBase64());
+}
+
+// 尺寸越界、数据长度与尺寸和类型不符时返回空矩阵，先校验再分配，损坏的文件不会抛异常
+cv::Mat matFromJson(const QJsonValue &value, const cv::Size &size, int type)
+{
+    if (size.width <= 0 || size.height <= 0 || size.width > MaxMapSide || size.height > MaxMapSide)
+    {
+        return cv::Mat();
+    }
+    const QByteArray raw = qUncompress(QByteArray::fromBase64(value.toString().toLatin1()));
+    if (size_t(raw.size()) != size_t(size.width) * size_t(size.height) * CV_ELEM_SIZE(type))
+    {
+        return cv::Mat();
+    }
+    cv::Mat mat(size, type);
+    std::memcpy(mat.data, raw.constData(), size_t(raw.size()));
+    return mat;
+}
+
+bool sameTable(const std::vector<cv::Point2d> &a, const std::vector<cv::Point2d> &b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+QJsonObject paramsToJson(const GaugeParams &params)
+{
+    QJsonArray points;
+    for (const auto &pt : params.sourcePoints)
+    {
+        points.append(pointArray(pt.x, pt.y));
+    }
+
+    QJsonObject json;
+    json["perspective"] = QJsonObject{
+        { "points", points },
+        { "width", params.outputWidth },
+        { "height", params.outputHeight }
+    };
+    json["blur"] = QJsonObject{
+        { "sigmaX", params.sigmaX },
+        { "sigmaY", params.sigmaY },
+        { "mode", enumName(BlurModeNames, params.blurMode) }
+    };
+    json["canny"] = QJsonObject{
+        { "threshold1", params.cannyThreshold1 },
+        { "threshold2", params.cannyThreshold2 }
+    };
+    json["circle"] = QJsonObject{
+        { "minRadius", params.minRadius },
+        { "maxRadius", params.maxRadius },
+        { "method", enumName(CircleMethodNames, params.circleMethod) },
+        { "pyramidLevels", params.circlePyramidLevels }
+    };
+    json["pointer"] = QJsonObject{
+        { "rho", params.rho },
+        { "theta", params.theta },
+        { "threshold", params.threshold },
+        { "minLineLength", params.minLineLength },
+        { "maxLineGap", params.maxLineGap },
+        { "method", enumName(PointerMethodNames, params.pointerMethod) }
+    };
+    json["range"] = QJsonObject{
+        { "min", params.gaugeMinValue },
+        { "max", params.gaugeMaxValue }
+    };
+
+    // 刻度表总是写出（没有自定义刻度表时为与量程等价的两点表），方便其他程序直接换算
+    QJsonArray table;
+    for (const auto &entry : GaugeCore::angleTable(params))
+    {
+        table.append(pointArray(entry.x, entry.y));
+    }
+    json["angleTable"] = table;
+    return json;
+}
+
+// 缺少的字段取 GaugeParams 的默认值
+GaugeParams paramsFromJson(const QJsonObject &json)
+{
+    GaugeParams params;
+
+    const QJsonObject perspective = json["perspective"].toObject();
+    const QJsonArray points = perspective["points"].toArray();
+    if (points.size() == 4)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            const QJsonArray pt = points[i].toArray();
+            params.sourcePoints[i] = cv::Point2f(float(pt[0].toDouble()), float(pt[1].toDouble()));
+        }
+    }
+    params.outputWidth = perspective["width"].toInt(params.outputWidth);
+    params.outputHeight = perspective["height"].toInt(params.outputHeight);
+
+    const QJsonObject blur = json["blur"].toObject();
+    params.sigmaX = blur["sigmaX"].toDouble(params.sigmaX);
+    params.sigmaY = blur["sigmaY"].toDouble(params.sigmaY);
+    params.blurMode = BlurEngine::Mode(enumValue(BlurModeNames, blur["mode"], params.blurMode));
+
+    const QJsonObject canny = json["canny"].toObject();
+    params.cannyThreshold1 = canny["threshold1"].toInt(params.cannyThreshold1);
+    params.cannyThreshold2 = canny["threshold2"].toInt(params.cannyThreshold2);
+
+    const QJsonObject circle = json["circle"].toObject();
+    params.minRadius = circle["minRadius"].toInt(params.minRadius);
+    params.maxRadius = circle["maxRadius"].toInt(params.maxRadius);
+    params.circleMethod = CircleDetector::Method(enumValue(CircleMethodNames, circle["method"], params.circleMethod));
+    params.circlePyramidLevels = circle["pyramidLevels"].toInt(params.circlePyramidLevels);
+
+    const QJsonObject pointer = json["pointer"].toObject();
+    params.rho = pointer["rho"].toInt(params.rho);
+    params.theta = pointer["theta"].toDouble(params.theta);
+    params.threshold = pointer["threshold"].toInt(params.threshold);
+    params.minLineLength = pointer["minLineLength"].toInt(params.minLineLength);
+    params.maxLineGap = pointer["maxLineGap"].toInt(params.maxLineGap);
+    params.pointerMethod = PointerDetector::Method(enumValue(PointerMethodNames, pointer["method"], params.pointerMethod));
+
+    const QJsonObject range = json["range"].toObject();
+    params.gaugeMinValue = range["min"].toDouble(params.gaugeMinValue);
+    params.gaugeMaxValue = range["max"].toDouble(params.gaugeMaxValue);
+
+    std::vector<cv::Point2d> table;
+    for (const auto &value : json["angleTable"].toArray())
+    {
+        const QJsonArray entry = value.toArray();
+        table.push_back(cv::Point2d(entry[0].toDouble(), entry[1].toDouble()));
+    }
+    // 与量程等价的表不写回 angleTable，界面上修改量程仍然生效
+    if (!sameTable(table, GaugeCore::angleTable(params)))
+    {
+        params.angleTable = table;
+    }
+    return params;
+}
+
+void setError(QString *error, const QString &message)
+{
+    if (error)
+    {
+        *error = message;
+    }
+}
+}
+
+GaugeProfile GaugeProfile::capture(const std::string &name, const GaugeParams &params, const GaugeResult &result)
+{
+    GaugeProfile profile;
+    profile.name = name;
+    profile.params = params;
+    profile.hasCircle = result.circleFound;
+    profile.circle = result.circle;
+    profile.circleSupport = result.circleSupport;
+    profile.warpMap = PerspectiveMapCache::instance().get(params.sourcePoints,
+                                                          cv::Size(params.outputWidth, params.outputHeight));
+    return profile;
+}
+
+bool GaugeProfile::hasValidWarpMap() const
+{
+    const cv::Size outputSize(params.outputWidth, params.outputHeight);
+    return warpMap && warpMap->outputSize == outputSize
+            && warpMap->key == PerspectiveMapCache::key(params.sourcePoints, outputSize);
+}
+
+void GaugeProfile::warmUp(GeometryLock *lock) const
+{
+    if (hasValidWarpMap())
+    {
+        PerspectiveMapCache::instance().insert(params.sourcePoints, warpMap);
+    }
+    if (lock && hasCircle)
+    {
+        lock->lock(params, circle, circleSupport);
+    }
+}
+
+
+// --------------------文件读写--------------------
+bool GaugeProfile::save(const QString &fileName, const std::vector<GaugeProfile> &profiles,
+                        bool includeWarpMap, QString *error)
+{
+    QJsonArray gauges;
+    for (const auto &profile : profiles)
+    {
+        QJsonObject gauge = paramsToJson(profile.params);
+        gauge["name"] = QString::fromStdString(profile.name);
+        if (profile.hasCircle)
+        {
+            gauge["lockedCircle"] = QJsonObject{
+                { "x", profile.circle[0] },
+                { "y", profile.circle[1] },
+                { "r", profile.circle[2] },
+                { "support", profile.circleSupport }
+            };
+        }
+        if (includeWarpMap && profile.warpMap && !profile.warpMap->map1.empty())
+        {
+            const PerspectiveMap &map = *profile.warpMap;
+            // 键为 64 位整数，超出 JSON 数值的精确范围，按十六进制字符串保存
+            gauge["warpMap"] = QJsonObject{
+                { "key", QString::number(qulonglong(map.key), 16) },
+                { "width", map.outputSize.width },
+                { "height", map.outputSize.height },
+                { "map1", matToJson(map.map1) },
+                { "map2", matToJson(map.map2) }
+            };
+        }
+        gauges.append(gauge);
+    }
+
+    QJsonObject root;
+    root["version"] = ProfileVersion;
+    root["gauges"] = gauges;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        setError(error, QString("无法写入配置文件: %1").arg(fileName));
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+bool GaugeProfile::load(const QString &fileName, std::vector<GaugeProfile> &profiles, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        setError(error, QString("无法打开配置文件: %1").arg(fileName));
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (document.isNull() || !document.isObject())
+    {
+        setError(error, QString("配置文件格式错误: %1").arg(parseError.errorString()));
+        return false;
+    }
+    const QJsonObject root = document.object();
+    if (root["version"].toInt() > ProfileVersion)
+    {
+        setError(error, QString("配置文件版本 %1 高于程序支持的版本 %2").arg(root["version"].toInt()).arg(ProfileVersion));
+        return false;
+    }
+
+    std::vector<GaugeProfile> loaded;
+    for (const auto &value : root["gauges"].toArray())
+    {
+        const QJsonObject gauge = value.toObject();
+        GaugeProfile profile;
+        profile.name = gauge["name"].toString().toStdString();
+        profile.params = paramsFromJson(gauge);
+
+        if (gauge.contains("lockedCircle"))
+        {
+            const QJsonObject circle = gauge["lockedCircle"].toObject();
+            profile.hasCircle = true;
+            profile.circle = cv::Vec3f(float(circle["x"].toDouble()), float(circle["y"].toDouble()),
+                                       float(circle["r"].toDouble()));
+            profile.circleSupport = circle["support"].toDouble();
+        }
+
+        // 映射表的键与源点和输出尺寸不符（手工改过参数、旧文件没有键）或数据损坏时丢弃，首帧按参数重新构建
+        if (gauge.contains("warpMap"))
+        {
+            const QJsonObject json = gauge["warpMap"].toObject();
+            const cv::Size size(json["width"].toInt(), json["height"].toInt());
+            bool keyOk = false;
+            const uint64_t key = json["key"].toString().toULongLong(&keyOk, 16);
+            if (keyOk && size == cv::Size(profile.params.outputWidth, profile.params.outputHeight)
+                    && key == PerspectiveMapCache::key(profile.params.sourcePoints, size))
+            {
+                auto map = std::make_shared<PerspectiveMap>();
+                map->outputSize = size;
+                map->key = key;
+                map->map1 = matFromJson(json["map1"], size, CV_16SC2);
+                map->map2 = matFromJson(json["map2"], size, CV_16UC1);
+                if (!map->map1.empty() && !map->map2.empty())
+                {
+                    profile.warpMap = map;
+                }
+            }
+        }
+        loaded.push_back(profile);
+    }
+
+    if (loaded.empty())
+    {
+        setError(error, QString("配置文件中没有仪表: %1").arg(fileName));
+        return false;
+    }
+    profiles.swap(loaded);
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef GAUGEPROFILE_H
+#define GAUGEPROFILE_H
+
+#include <QString>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GaugeCore.h"
+#include "GeometryLock.h"
+#include "PerspectiveMap.h"
+
+// 一块表的配置文件内容：全部识别参数，加上由参数算出的标定数据（透视映射表、锁定的表盘圆、刻度表）。
+// 加载已知表的配置后直接从锁定状态开始，不需要重新调参和完整检测
+struct GaugeProfile
+{
+    std::string name;
+    GaugeParams params;
+
+    // 锁定的表盘圆（透视变换后坐标）和当时的边缘支持率
+    bool hasCircle = false;
+    cv::Vec3f circle;
+    double circleSupport = 0.0;
+
+    // 与 params 的源点和输出尺寸对应的映射表，为空时首帧重新构建
+    std::shared_ptr<const PerspectiveMap> warpMap;
+
+    // warpMap 存在且其键与当前的源点和输出尺寸一致（参数改过之后映射表作废）
+    bool hasValidWarpMap() const;
+
+    // 由当前参数和一次识别结果生成配置，映射表取自 PerspectiveMapCache
+    static GaugeProfile capture(const std::string &name, const GaugeParams &params, const GaugeResult &result);
+
+    // 有效的映射表放入 PerspectiveMapCache（单表使用；多表模式由 MultiGaugeReader 直接持有各表的映射表，
+    // 不受缓存容量限制）；lock 不为空时把表盘圆锁定到 lock（lock 需已启用才会生效）
+    void warmUp(GeometryLock *lock) const;
+
+    // JSON 文件，一个文件可以有多块表（多表模式）。映射表压缩后按 base64 内嵌，
+    // 为本机字节序，只在同类机器之间通用；includeWarpMap 为 false 时文件只有几 KB
+    static bool save(const QString &fileName, const std::vector<GaugeProfile> &profiles,
+                     bool includeWarpMap = true, QString *error = nullptr);
+    static bool load(const QString &fileName, std::vector<GaugeProfile> &profiles, QString *error = nullptr);
+};
+
+#endif // GAUGEPROFILE_H
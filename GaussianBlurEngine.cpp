@@ -0,0 +1,581 @@
+#include "GaussianBlurEngine.h"
+#include "SimdDispatch.h"
+#include "StageCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace BlurEngine
+{
+
+int reflect101(int i, int n)
+{
+    if (n == 1)
+    {
+        return 0;
+    }
+    while (i < 0 || i >= n)
+    {
+        i = i < 0 ? -i : 2 * n - 2 - i;
+    }
+    return i;
+}
+
+
+// --------------------高斯核缓存--------------------
+namespace
+{
+std::mutex g_kernelMutex;
+StageCache<std::shared_ptr<const Kernel>> g_kernelCache(32);
+
+std::shared_ptr<const Kernel> buildGaussianKernel(int size, double sigma)
+{
+    auto kernel = std::make_shared<Kernel>();
+    kernel->size = size;
+    kernel->sigma = sigma > 0 ? sigma : ((size - 1) * 0.5 - 1) * 0.3 + 0.8;
+    kernel->coef.resize(size);
+
+    std::vector<double> weights(size);
+    double total = 0.0;
+    const double scale = -0.5 / (kernel->sigma * kernel->sigma);
+    for (int i = 0; i < size; ++i)
+    {
+        const double x = i - (size - 1) * 0.5;
+        weights[i] = std::exp(scale * x * x);
+        total += weights[i];
+    }
+
+    // 量化后的误差补到中心系数上，保证系数和严格为 1 << CoefBits
+    int sum = 0;
+    for (int i = 0; i < size; ++i)
+    {
+        kernel->coef[i] = int16_t(std::lround(weights[i] / total * (1 << CoefBits)));
+        sum += kernel->coef[i];
+    }
+    kernel->coef[size / 2] = int16_t(kernel->coef[size / 2] + (1 << CoefBits) - sum);
+    return kernel;
+}
+}
+
+std::shared_ptr<const Kernel> gaussianKernel(int size, double sigma)
+{
+    size = std::max(1, std::min(MaxKernelSize, size | 1));
+
+    StageKey key;
+    key.add(size).add(sigma > 0 ? sigma : 0.0);
+
+    std::lock_guard<std::mutex> lock(g_kernelMutex);
+    if (const auto *cached = g_kernelCache.find(key.value()))
+    {
+        return *cached;
+    }
+    return g_kernelCache.insert(key.value(), buildGaussianKernel(size, sigma));
+}
+
+size_t kernelCacheSize()
+{
+    std::lock_guard<std::mutex> lock(g_kernelMutex);
+    return g_kernelCache.size();
+}
+
+
+// --------------------行内核--------------------
+// K > 0 时核尺寸为编译期常量，循环完全展开；K == 0 为通用实现。
+// 水平：u8 输入 × Q8 系数，结果四舍五入到 Q7 存为 int16（最大 32640）
+// 垂直：Q7 输入 × Q8 系数，结果四舍五入右移 15 位得到 u8
+namespace
+{
+
+template <int K>
+void horizontalScalar(const uint8_t *src, int16_t *dst, int width, const int16_t *coef, int ksize)
+{
+    const int n = K > 0 ? K : ksize;
+    for (int x = 0; x < width; ++x)
+    {
+        int32_t sum = 0;
+        for (int k = 0; k < n; ++k)
+        {
+            sum += src[x + k] * coef[k];
+        }
+        dst[x] = int16_t((sum + 1) >> 1);
+    }
+}
+
+template <int K>
+void verticalScalar(const int16_t *const *rows, uint8_t *dst, int begin, int width, const int16_t *coef, int ksize)
+{
+    const int n = K > 0 ? K : ksize;
+    for (int x = begin; x < width; ++x)
+    {
+        int32_t sum = 0;
+        for (int k = 0; k < n; ++k)
+        {
+            sum += rows[k][x] * coef[k];
+        }
+        dst[x] = uint8_t(std::min(255, std::max(0, (sum + (1 << 14)) >> 15)));
+    }
+}
+
+#if defined(SIMD_HAS_SSE2)
+// 相邻两个抽头交错成 16 位对，与 (c[k], c[k+1]) 做 madd，一次完成两次乘加
+template <int K>
+SIMD_TARGET_SSE2
+void horizontalSse2(const uint8_t *src, int16_t *dst, int width, const int16_t *coef, int ksize)
+{
+    const int n = K > 0 ? K : ksize;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        int k = 0;
+        for (; k + 1 < n; k += 2)
+        {
+            const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + x + k)), zero);
+            const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + x + k + 1)), zero);
+            const __m128i c = _mm_set1_epi32(int(uint16_t(coef[k])) | (int(coef[k + 1]) << 16));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+        }
+        if (k < n)
+        {
+            const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + x + k)), zero);
+            const __m128i c = _mm_set1_epi32(int(uint16_t(coef[k])));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), c));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), c));
+        }
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, one), 1);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, one), 1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_packs_epi32(lo, hi));
+    }
+    horizontalScalar<K>(src + x, dst + x, width - x, coef, ksize);
+}
+
+template <int K>
+SIMD_TARGET_SSE2
+void verticalSse2(const int16_t *const *rows, uint8_t *dst, int width, const int16_t *coef, int ksize)
+{
+    const int n = K > 0 ? K : ksize;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << 14);
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        int k = 0;
+        for (; k + 1 < n; k += 2)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[k] + x));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[k + 1] + x));
+            const __m128i c = _mm_set1_epi32(int(uint16_t(coef[k])) | (int(coef[k + 1]) << 16));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b), c));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b), c));
+        }
+        if (k < n)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[k] + x));
+            const __m128i c = _mm_set1_epi32(int(uint16_t(coef[k])));
+            lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, zero), c));
+            hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, zero), c));
+        }
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, round), 15);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, round), 15);
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(lo, hi), zero);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + x), packed);
+    }
+    verticalScalar<K>(rows, dst, x, width, coef, ksize);
+}
+#endif
+
+#if defined(SIMD_HAS_AVX2)
+// unpacklo/hi 在每个 128 位通道内交错，madd 后 packs 同样按通道打包，正好恢复原始顺序
+template <int K>
+SIMD_TARGET_AVX2
+void horizontalAvx2(const uint8_t *src, int16_t *dst, int width, const int16_t *coef, int ksize)
+{
+    const int n = K > 0 ? K : ksize;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        __m256i lo = _mm256_setzero_si256();
+        __m256i hi = _mm256_setzero_si256();
+        int k = 0;
+        for (; k + 1 < n; k += 2)
+        {
+            const __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x + k)));
+            const __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x + k + 1)));
+            const __m256i c = _mm256_set1_epi32(int(uint16_t(coef[k])) | (int(coef[k + 1]) << 16));
+            lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), c));
+            hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), c));
+        }
+        if (k < n)
+        {
+            const __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x + k)));
+            const __m256i c = _mm256_set1_epi32(int(uint16_t(coef[k])));
+            lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, zero), c));
+            hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, zero), c));
+        }
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, one), 1);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, one), 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x), _mm256_packs_epi32(lo, hi));
+    }
+    horizontalScalar<K>(src + x, dst + x, width - x, coef, ksize);
+}
+
+template <int K>
+SIMD_TARGET_AVX2
+void verticalAvx2(const int16_t *const *rows, uint8_t *dst, int width, const int16_t *coef, int ksize)
+{
+    const int n = K > 0 ? K : ksize;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi32(1 << 14);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        __m256i lo = _mm256_setzero_si256();
+        __m256i hi = _mm256_setzero_si256();
+        int k = 0;
+        for (; k + 1 < n; k += 2)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows[k] + x));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows[k + 1] + x));
+            const __m256i c = _mm256_set1_epi32(int(uint16_t(coef[k])) | (int(coef[k + 1]) << 16));
+            lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), c));
+            hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), c));
+        }
+        if (k < n)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows[k] + x));
+            const __m256i c = _mm256_set1_epi32(int(uint16_t(coef[k])));
+            lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, zero), c));
+            hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, zero), c));
+        }
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, round), 15);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, round), 15);
+        // 16 个 u8 分布在两个通道的低 8 字节，permute 后拼到低 128 位
+        const __m256i packed = _mm256_permute4x64_epi64(
+                    _mm256_packus_epi16(_mm256_packs_epi32(lo, hi), zero), 0xD8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm256_castsi256_si128(packed));
+    }
+    verticalScalar<K>(rows, dst, x, width, coef, ksize);
+}
+#endif
+
+template <int K>
+void horizontalDispatch(const uint8_t *src, int16_t *dst, int width, const int16_t *coef, int ksize)
+{
+    switch (Simd::activeIsa())
+    {
+#if defined(SIMD_HAS_AVX2)
+    case Simd::IsaAvx2:
+        horizontalAvx2<K>(src, dst, width, coef, ksize);
+        return;
+#endif
+#if defined(SIMD_HAS_SSE2)
+    case Simd::IsaSse2:
+        horizontalSse2<K>(src, dst, width, coef, ksize);
+        return;
+#endif
+    default:
+        horizontalScalar<K>(src, dst, width, coef, ksize);
+        return;
+    }
+}
+
+template <int K>
+void verticalDispatch(const int16_t *const *rows, uint8_t *dst, int width, const int16_t *coef, int ksize)
+{
+    switch (Simd::activeIsa())
+    {
+#if defined(SIMD_HAS_AVX2)
+    case Simd::IsaAvx2:
+        verticalAvx2<K>(rows, dst, width, coef, ksize);
+        return;
+#endif
+#if defined(SIMD_HAS_SSE2)
+    case Simd::IsaSse2:
+        verticalSse2<K>(rows, dst, width, coef, ksize);
+        return;
+#endif
+    default:
+        verticalScalar<K>(rows, dst, 0, width, coef, ksize);
+        return;
+    }
+}
+
+}
+
+
+// --------------------可分离滤波--------------------
+namespace
+{
+// 每个线程一份的工作内存，按需要的最大尺寸增长
+struct SeparableBuffers
+{
+    std::vector<uint8_t> row;
+    std::vector<int16_t> ring;
+    std::vector<const int16_t *> rows;
+    std::vector<int> ringRow;
+};
+
+template <typename T>
+T *grow(std::vector<T> &buffer, size_t size)
+{
+    if (buffer.size() < size)
+    {
+        buffer.resize(size);
+    }
+    return buffer.data();
+}
+}
+
+SeparableBlur::SeparableBlur(const Kernel &kx, const Kernel &ky, int width, int height)
+    : m_kx(kx)
+    , m_ky(ky)
+    , m_width(width)
+    , m_height(height)
+{
+    thread_local SeparableBuffers buffers;
+    m_row = grow(buffers.row, size_t(width + kx.size - 1));
+    m_ring = grow(buffers.ring, size_t(ky.size) * width);
+    m_rows = grow(buffers.rows, size_t(ky.size));
+    m_ringRow = grow(buffers.ringRow, size_t(ky.size));
+}
+
+void SeparableBlur::horizontal(int16_t *out)
+{
+    // 输入行已写到 m_row + rx，这里补左右反射边界
+    const int rx = m_kx.size / 2;
+    uint8_t *row = m_row + rx;
+    for (int i = 1; i <= rx; ++i)
+    {
+        row[-i] = row[reflect101(-i, m_width)];
+        row[m_width - 1 + i] = row[reflect101(m_width - 1 + i, m_width)];
+    }
+
+    const int16_t *coef = m_kx.coef.data();
+    switch (m_kx.size)
+    {
+    case 3: horizontalDispatch<3>(m_row, out, m_width, coef, 3); break;
+    case 5: horizontalDispatch<5>(m_row, out, m_width, coef, 5); break;
+    case 7: horizontalDispatch<7>(m_row, out, m_width, coef, 7); break;
+    case 9: horizontalDispatch<9>(m_row, out, m_width, coef, 9); break;
+    default: horizontalDispatch<0>(m_row, out, m_width, coef, m_kx.size); break;
+    }
+}
+
+void SeparableBlur::vertical(uint8_t *out) const
+{
+    const int16_t *const *rows = m_rows;
+    const int16_t *coef = m_ky.coef.data();
+    switch (m_ky.size)
+    {
+    case 3: verticalDispatch<3>(rows, out, m_width, coef, 3); break;
+    case 5: verticalDispatch<5>(rows, out, m_width, coef, 5); break;
+    case 7: verticalDispatch<7>(rows, out, m_width, coef, 7); break;
+    case 9: verticalDispatch<9>(rows, out, m_width, coef, 9); break;
+    default: verticalDispatch<0>(rows, out, m_width, coef, m_ky.size); break;
+    }
+}
+
+void gaussianBlur(const uint8_t *src, size_t srcStep, uint8_t *dst, size_t dstStep,
+                  int width, int height, int ksize, double sigmaX, double sigmaY)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    auto kx = gaussianKernel(ksize, sigmaX);
+    auto ky = gaussianKernel(ksize, sigmaY > 0 ? sigmaY : sigmaX);
+    SeparableBlur blur(*kx, *ky, width, height);
+    blur.run([&](int y, uint8_t *row) {
+        std::memcpy(row, src + y * srcStep, size_t(width));
+    }, dst, dstStep);
+}
+
+
+// --------------------盒式滤波近似--------------------
+namespace
+{
+// n 次盒式滤波逼近给定 sigma 时各次的窗口宽度（奇数），写入 sizes[0, n)
+void boxSizesForGauss(double sigma, int n, int *sizes)
+{
+    const double ideal = std::sqrt(12.0 * sigma * sigma / n + 1.0);
+    int wl = int(std::floor(ideal));
+    if (wl % 2 == 0)
+    {
+        --wl;
+    }
+    wl = std::max(1, wl);
+    const int wu = wl + 2;
+    const double mIdeal = (12.0 * sigma * sigma - n * wl * wl - 4.0 * n * wl - 3.0 * n) / (-4.0 * wl - 4.0);
+    const int m = int(std::lround(mIdeal));
+
+    for (int i = 0; i < n; ++i)
+    {
+        sizes[i] = std::min(MaxKernelSize, i < m ? wl : wu);
+    }
+}
+
+// 窗口和 -> 均值：(sum + size / 2) * inv >> 16，inv = 2^16 / size。
+// 窗口最大 63 个像素，和与乘积的高 16 位都在 16 位内，SSE2 下用 mulhi 一次算 8 个
+inline uint8_t boxMean(uint16_t sum, uint32_t half, uint32_t inv)
+{
+    return uint8_t(((sum + half) * inv) >> 16);
+}
+
+#if defined(SIMD_HAS_SSE2)
+SIMD_TARGET_SSE2
+int boxMeanSse2(const uint16_t *sum, uint8_t *out, int width, uint32_t half, uint32_t inv)
+{
+    const __m128i h = _mm_set1_epi16(short(half));
+    const __m128i m = _mm_set1_epi16(short(inv));
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        const __m128i v = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + x)), h);
+        const __m128i q = _mm_mulhi_epu16(v, m);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + x), _mm_packus_epi16(q, q));
+    }
+    return x;
+}
+#endif
+
+void boxMeanRow(const uint16_t *sum, uint8_t *out, int width, int size)
+{
+    if (size == 1)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            out[x] = uint8_t(sum[x]);
+        }
+        return;
+    }
+
+    const uint32_t half = uint32_t(size / 2);
+    const uint32_t inv = (1u << 16) / uint32_t(size);
+    int x = 0;
+#if defined(SIMD_HAS_SSE2)
+    if (Simd::activeIsa() >= Simd::IsaSse2)
+    {
+        x = boxMeanSse2(sum, out, width, half, inv);
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        out[x] = boxMean(sum[x], half, inv);
+    }
+}
+
+// 水平盒式滤波：先求 16 位前缀和（按 2^16 取模，窗口和不超过 16 位所以差值仍然精确），
+// 窗口和就是两个前缀和之差，每像素代价与窗口大小无关
+void boxHorizontal(const uint8_t *src, size_t srcStep, uint8_t *dst, size_t dstStep,
+                   int width, int height, int size)
+{
+    const int r = size / 2;
+    const size_t lineSize = size_t(width + 2 * r);
+    thread_local std::vector<uint8_t> lineBuffer;
+    thread_local std::vector<uint16_t> prefixBuffer;
+    thread_local std::vector<uint16_t> sumsBuffer;
+    uint8_t *line = grow(lineBuffer, lineSize);
+    uint16_t *prefix = grow(prefixBuffer, lineSize + 1);
+    uint16_t *sums = grow(sumsBuffer, size_t(width));
+    uint8_t *padded = line + r;
+    for (int y = 0; y < height; ++y)
+    {
+        std::memcpy(padded, src + y * srcStep, size_t(width));
+        for (int i = 1; i <= r; ++i)
+        {
+            padded[-i] = padded[reflect101(-i, width)];
+            padded[width - 1 + i] = padded[reflect101(width - 1 + i, width)];
+        }
+
+        uint16_t acc = 0;
+        prefix[0] = 0;
+        for (size_t i = 0; i < lineSize; ++i)
+        {
+            acc = uint16_t(acc + line[i]);
+            prefix[i + 1] = acc;
+        }
+        for (int x = 0; x < width; ++x)
+        {
+            sums[x] = uint16_t(prefix[x + size] - prefix[x]);
+        }
+        boxMeanRow(sums, dst + y * dstStep, width, size);
+    }
+}
+
+// 垂直盒式滤波，按列维护窗口和，内层循环沿行方向连续访问。
+// src 与 dst 不能是同一块内存
+void boxVertical(const uint8_t *src, size_t srcStep, uint8_t *dst, size_t dstStep,
+                 int width, int height, int size)
+{
+    const int r = size / 2;
+    auto row = [&](int y) { return src + reflect101(y, height) * srcStep; };
+
+    thread_local std::vector<uint16_t> sums;
+    sums.assign(size_t(width), 0);
+    for (int i = -r; i <= r; ++i)
+    {
+        const uint8_t *in = row(i);
+        for (int x = 0; x < width; ++x)
+        {
+            sums[x] = uint16_t(sums[x] + in[x]);
+        }
+    }
+
+    for (int y = 0; y < height; ++y)
+    {
+        boxMeanRow(sums.data(), dst + y * dstStep, width, size);
+        const uint8_t *add = row(y + r + 1);
+        const uint8_t *sub = row(y - r);
+        uint16_t *s = sums.data();
+        for (int x = 0; x < width; ++x)
+        {
+            s[x] = uint16_t(s[x] + add[x] - sub[x]);
+        }
+    }
+}
+}
+
+void boxBlurApprox(const uint8_t *src, size_t srcStep, uint8_t *dst, size_t dstStep,
+                   int width, int height, double sigmaX, double sigmaY)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
+
+    const double sx = sigmaX > 0 ? sigmaX : 1.7;
+    const double sy = sigmaY > 0 ? sigmaY : sx;
+    int boxX[3];
+    int boxY[3];
+    boxSizesForGauss(sx, 3, boxX);
+    boxSizesForGauss(sy, 3, boxY);
+
+    // 每次先水平滤波到临时图（每个线程复用），再垂直滤波回 dst
+    thread_local std::vector<uint8_t> tempBuffer;
+    uint8_t *temp = grow(tempBuffer, size_t(width) * height);
+    const uint8_t *in = src;
+    size_t inStep = srcStep;
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        boxHorizontal(in, inStep, temp, size_t(width), width, height, boxX[pass]);
+        boxVertical(temp, size_t(width), dst, dstStep, width, height, boxY[pass]);
+        in = dst;
+        inStep = dstStep;
+    }
+}
+
+}
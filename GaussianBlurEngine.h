@@ -0,0 +1,110 @@
+#ifndef GAUSSIANBLURENGINE_H
+#define GAUSSIANBLURENGINE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 8 位灰度图的可分离高斯模糊。
+// 系数为 Q8 定点数（8 位小数，和为 1 << CoefBits = 256，以 int16 存放），水平结果以 Q7 的 16 位整数暂存；
+// 9 阶核、sigma 0.8-3 时与双精度计算再四舍五入的结果相差不超过 1 个灰度级。
+// 3/5/7/9 阶核在编译期特化展开，其余尺寸走通用实现；SSE2/AVX2 由 SimdDispatch 运行时选择。
+// 另提供多次盒式滤波近似高斯的快速模式，供实时调参使用
+namespace BlurEngine
+{
+
+const int CoefBits = 8;
+const int MaxKernelSize = 63;
+
+enum Mode
+{
+    ExactGaussian,  // 可分离高斯，与精确结果相差不超过 1 个灰度级（见上）
+    FastBox         // 三次盒式滤波近似，代价与 sigma 无关，sigma 较大时明显快于精确高斯
+};
+
+// 对称一维核
+struct Kernel
+{
+    int size = 0;
+    double sigma = 0.0;
+    std::vector<int16_t> coef;
+};
+
+// 按 (size, sigma) 缓存的高斯核，sigma <= 0 时按 OpenCV 的规则由 size 推出；线程安全
+std::shared_ptr<const Kernel> gaussianKernel(int size, double sigma);
+size_t kernelCacheSize();
+
+// 行流式可分离滤波：逐行取输入，环形缓冲中只保留核高度的水平滤波结果，
+// 因此输入行可以由其他内核现算（例如透视变换 + 灰度化），不必先生成整幅图像。
+// 边界均为 BORDER_REFLECT_101。行缓冲和环形缓冲是调用线程的工作内存，只增不减，
+// 同尺寸的连续帧不再分配；同一线程中同时只能有一个 SeparableBlur
+class SeparableBlur
+{
+public:
+    SeparableBlur(const Kernel &kx, const Kernel &ky, int width, int height);
+
+    // produce(y, row) 把第 y 行的 width 个像素写到 row；每行只会被请求一次，
+    // 且在输出第 y 行之前不会请求 y + 核半径之后的行（因此允许 src 与 dst 为同一块内存）
+    template <typename Producer>
+    void run(Producer produce, uint8_t *dst, size_t dstStep);
+
+private:
+    void horizontal(int16_t *out);
+    void vertical(uint8_t *out) const;
+
+    const Kernel &m_kx;
+    const Kernel &m_ky;
+    int m_width;
+    int m_height;
+    uint8_t *m_row;             // 带左右边界的输入行
+    int16_t *m_ring;            // 水平滤波结果环形缓冲
+    const int16_t **m_rows;     // 当前输出行用到的 ky 行
+    int *m_ringRow;             // 环形缓冲各槽位中的源行号
+};
+
+// 整幅高斯模糊（ksize 为奇数，sigmaY <= 0 时取 sigmaX，与 cv::GaussianBlur 一致）
+void gaussianBlur(const uint8_t *src, size_t srcStep, uint8_t *dst, size_t dstStep,
+                  int width, int height, int ksize, double sigmaX, double sigmaY);
+
+// 三次盒式滤波近似高斯
+void boxBlurApprox(const uint8_t *src, size_t srcStep, uint8_t *dst, size_t dstStep,
+                   int width, int height, double sigmaX, double sigmaY);
+
+int reflect101(int i, int n);
+
+
+// --------------------模板实现--------------------
+template <typename Producer>
+void SeparableBlur::run(Producer produce, uint8_t *dst, size_t dstStep)
+{
+    const int ky = m_ky.size;
+    const int ry = ky / 2;
+    const int rx = m_kx.size / 2;
+    int *ringRow = m_ringRow;
+    std::fill(ringRow, ringRow + ky, -1);
+
+    for (int y = 0; y < m_height; ++y)
+    {
+        // 需要的源行都落在 [y - ry, y + ry] 内，环形缓冲中互不冲突
+        for (int k = 0; k < ky; ++k)
+        {
+            const int sy = reflect101(y - ry + k, m_height);
+            const int slot = sy % ky;
+            int16_t *h = m_ring + size_t(slot) * m_width;
+            if (ringRow[slot] != sy)
+            {
+                produce(sy, m_row + rx);
+                horizontal(h);
+                ringRow[slot] = sy;
+            }
+            m_rows[k] = h;
+        }
+        vertical(dst + y * dstStep);
+    }
+}
+
+}
+
+#endif // GAUSSIANBLURENGINE_H
@@ -0,0 +1,109 @@
+#include "GeometryLock.h"
+#include "StageCache.h"
+#include <algorithm>
+
+GeometryLock::GeometryLock()
+    : m_enabled(false)
+    , m_locked(false)
+    , m_key(0)
+    , m_support(0.0)
+    , m_score(0.0)
+    , m_lockSupport(0.5)
+    , m_verifyRatio(0.75)
+    , m_verified(0)
+    , m_detected(0)
+{
+}
+
+void GeometryLock::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled)
+    {
+        reset();
+    }
+}
+
+void GeometryLock::setThresholds(double lockSupport, double verifyRatio)
+{
+    m_lockSupport = lockSupport;
+    m_verifyRatio = verifyRatio;
+}
+
+void GeometryLock::reset()
+{
+    m_locked = false;
+    m_key = 0;
+    m_circle = cv::Vec3f();
+    m_support = 0.0;
+    m_score = 0.0;
+}
+
+void GeometryLock::lock(const GaugeParams &params, const cv::Vec3f &circle, double support)
+{
+    m_locked = true;
+    m_key = geometryKey(params);
+    m_circle = circle;
+    m_support = support;
+    m_score = support;
+}
+
+uint64_t GeometryLock::geometryKey(const GaugeParams &params)
+{
+    StageKey key;
+    for (const auto &pt : params.sourcePoints)
+    {
+        key.add(pt.x).add(pt.y);
+    }
+    key.add(params.outputWidth).add(params.outputHeight);
+    key.add(params.minRadius).add(params.maxRadius);
+    // 换检测方法或金字塔层数时也要重新检测，否则新方法一次都不会运行
+    key.add(int(params.circleMethod)).add(params.circlePyramidLevels);
+    return key.value();
+}
+
+void GeometryLock::detectCircles(const cv::Mat &blurred, const cv::Mat &edges, const EdgeGradients &gradients,
+                                 const GaugeParams &params, GaugeResult &result)
+{
+    if (!m_enabled)
+    {
+        GaugeCore::detectCircles(blurred, edges, gradients, params, result);
+        return;
+    }
+
+    const uint64_t key = geometryKey(params);
+    if (m_locked && key != m_key)
+    {
+        reset();
+    }
+
+    // 已锁定：只沿锁定的圆周数边缘，代价为几百次查表
+    if (m_locked)
+    {
+        const double support = GaugeCore::circleEdgeSupport(edges, m_circle);
+        if (support >= m_support * m_verifyRatio)
+        {
+            result.circleFound = true;
+            result.circle = m_circle;
+            result.circleSupport = support;
+            // 检测方法的置信度按当前帧与锁定时的支持率之比折算
+            result.circleScore = std::min(1.0, m_score * support / std::max(m_support, 1e-6));
+            result.circleLocked = true;
+            ++m_verified;
+            return;
+        }
+        reset();
+    }
+
+    // 未锁定或验证失败：完整检测，足够可靠时锁定
+    GaugeCore::detectCircles(blurred, edges, gradients, params, result);
+    ++m_detected;
+    if (result.circleFound && result.circleSupport >= m_lockSupport)
+    {
+        m_locked = true;
+        m_key = key;
+        m_circle = result.circle;
+        m_support = result.circleSupport;
+        m_score = result.circleScore;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef GEOMETRYLOCK_H
+#define GEOMETRYLOCK_H
+
+#include "GaugeCore.h"
+#include <cstdint>
+
+// 几何锁定：固定机位下表盘不会移动，一次可靠的圆检测之后锁定圆心和半径，
+// 后续帧只沿锁定的圆周检查边缘支持率，检查不通过才重新完整检测。
+// 锁定与“透视变换 + 半径范围 + 圆检测方法和金字塔层数”参数绑定，这些参数一变即解锁（透视映射表本身由 PerspectiveMapCache 复用）
+class GeometryLock
+{
+public:
+    GeometryLock();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // 完整检测的支持率不低于 lockSupport 时锁定；验证时支持率不低于锁定时的 verifyRatio 倍即通过
+    void setThresholds(double lockSupport, double verifyRatio);
+    double lockSupport() const { return m_lockSupport; }
+    double verifyRatio() const { return m_verifyRatio; }
+
+    bool isLocked() const { return m_locked; }
+    const cv::Vec3f &circle() const { return m_circle; }
+    void reset();
+    // 直接锁定已知的圆（例如从仪表配置文件加载），support 为当时的边缘支持率，也作为检测置信度。
+    // 下一帧只做验证；params 的几何参数与锁定时不同则照常解锁
+    void lock(const GaugeParams &params, const cv::Vec3f &circle, double support);
+    double support() const { return m_support; }
+
+    // 代替 GaugeCore::detectCircles。未启用时直接完整检测；
+    // 结果来自锁定的圆时 result.circleLocked 为 true
+    void detectCircles(const cv::Mat &blurred, const cv::Mat &edges, const EdgeGradients &gradients,
+                       const GaugeParams &params, GaugeResult &result);
+
+    // 验证通过（跳过检测）与完整检测的次数
+    uint64_t verifiedCount() const { return m_verified; }
+    uint64_t detectedCount() const { return m_detected; }
+
+private:
+    static uint64_t geometryKey(const GaugeParams &params);
+
+    bool m_enabled;
+    bool m_locked;
+    uint64_t m_key;
+    cv::Vec3f m_circle;
+    double m_support;   // 锁定时的支持率
+    double m_score;     // 锁定时检测方法给出的置信度
+
+    double m_lockSupport;
+    double m_verifyRatio;
+
+    uint64_t m_verified;
+    uint64_t m_detected;
+};
+
+#endif // GEOMETRYLOCK_H
@@ -0,0 +1,302 @@
+#include "GrayWarpKernel.h"
+#include "SimdDispatch.h"
+#include <algorithm>
+#include <cstring>
+
+namespace GrayWarp
+{
+
+namespace
+{
+
+// BGR -> 灰度系数（与 cv::COLOR_BGR2GRAY 相同，和为 1 << 14）
+const int CoefB = 1868;
+const int CoefG = 9617;
+const int CoefR = 4899;
+
+// 双线性插值的分数位数（与 OpenCV 的 INTER_BITS 相同）
+const int InterBits = 5;
+const int InterTabSize = 1 << InterBits;
+const int InterMask = InterTabSize - 1;
+
+// 灰度值，保留 6 位小数（系数和 2^14，右移 8 位）
+inline int lumaQ6(const uint8_t *p)
+{
+    return (p[0] * CoefB + p[1] * CoefG + p[2] * CoefR + 128) >> 8;
+}
+
+inline int lumaQ6At(const SourceImage &src, int x, int y)
+{
+    if (unsigned(x) >= unsigned(src.width) || unsigned(y) >= unsigned(src.height))
+    {
+        return 0;
+    }
+    return lumaQ6(src.data + y * src.step + x * 3);
+}
+
+// 单个像素的标量实现，四个权重的和为 2^10，结果再右移 16 位
+inline uint8_t warpGrayPixel(const SourceImage &src, int x0, int y0, int f)
+{
+    const int fx = f & InterMask;
+    const int fy = f >> InterBits;
+    const int w00 = (InterTabSize - fx) * (InterTabSize - fy);
+    const int w01 = fx * (InterTabSize - fy);
+    const int w10 = (InterTabSize - fx) * fy;
+    const int w11 = fx * fy;
+
+    int l00, l01, l10, l11;
+    if (x0 >= 0 && y0 >= 0 && x0 + 1 < src.width && y0 + 1 < src.height)
+    {
+        const uint8_t *p = src.data + y0 * src.step + x0 * 3;
+        l00 = lumaQ6(p);
+        l01 = lumaQ6(p + 3);
+        l10 = lumaQ6(p + src.step);
+        l11 = lumaQ6(p + src.step + 3);
+    }
+    else
+    {
+        l00 = lumaQ6At(src, x0, y0);
+        l01 = lumaQ6At(src, x0 + 1, y0);
+        l10 = lumaQ6At(src, x0, y0 + 1);
+        l11 = lumaQ6At(src, x0 + 1, y0 + 1);
+    }
+
+    return uint8_t((l00 * w00 + l01 * w01 + l10 * w10 + l11 * w11 + (1 << 15)) >> 16);
+}
+
+void warpGrayRowScalar(const SourceImage &src, const int16_t *xy, const uint16_t *frac,
+                       uint8_t *dst, int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        dst[i] = warpGrayPixel(src, xy[2 * i], xy[2 * i + 1], frac[i]);
+    }
+}
+
+#if defined(SIMD_HAS_SSE2)
+// 四个角点的 BGR 打包在 32 位通道中（低 24 位），一次算出 4 个像素的双线性灰度。
+// 灰度：B、R 放在 16 位对里与 (CoefB, CoefR) 做 madd，G 单独与 CoefG 做 madd；
+// 插值：把 (l00, l01)、(l10, l11) 分别打包成 16 位对，与对应权重对做 madd
+SIMD_TARGET_SSE2
+inline __m128i lumaQ6Sse2(__m128i bgr)
+{
+    const __m128i maskBR = _mm_set1_epi32(0x00FF00FF);
+    const __m128i maskG = _mm_set1_epi32(0x000000FF);
+    const __m128i coefBR = _mm_set1_epi32((CoefR << 16) | CoefB);
+    const __m128i coefG = _mm_set1_epi32(CoefG);
+    __m128i l = _mm_add_epi32(_mm_madd_epi16(_mm_and_si128(bgr, maskBR), coefBR),
+                              _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(bgr, 8), maskG), coefG));
+    return _mm_srli_epi32(_mm_add_epi32(l, _mm_set1_epi32(128)), 8);
+}
+
+inline uint32_t loadBgr(const uint8_t *p)
+{
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+}
+
+SIMD_TARGET_SSE2
+void warpGrayRowSse2(const SourceImage &src, const int16_t *xy, const uint16_t *frac,
+                     uint8_t *dst, int width)
+{
+    const __m128i mask16 = _mm_set1_epi32(0xFFFF);
+    const __m128i tab = _mm_set1_epi32(InterTabSize);
+    const __m128i interMask = _mm_set1_epi32(InterMask);
+    const __m128i round = _mm_set1_epi32(1 << 15);
+
+    int i = 0;
+    for (; i + 4 <= width; i += 4)
+    {
+        // 4 个像素的四邻点都在图像内时走向量路径，否则整组退回标量
+        bool inside = true;
+        alignas(16) uint32_t c00[4], c01[4], c10[4], c11[4];
+        for (int k = 0; k < 4 && inside; ++k)
+        {
+            const int x0 = xy[2 * (i + k)];
+            const int y0 = xy[2 * (i + k) + 1];
+            inside = x0 >= 0 && y0 >= 0 && x0 + 1 < src.width && y0 + 1 < src.height;
+            if (inside)
+            {
+                const uint8_t *p = src.data + y0 * src.step + x0 * 3;
+                c00[k] = loadBgr(p);
+                c01[k] = loadBgr(p + 3);
+                c10[k] = loadBgr(p + src.step);
+                c11[k] = loadBgr(p + src.step + 3);
+            }
+        }
+        if (!inside)
+        {
+            warpGrayRowScalar(src, xy, frac, dst, i, i + 4);
+            continue;
+        }
+
+        const __m128i l00 = lumaQ6Sse2(_mm_load_si128(reinterpret_cast<const __m128i *>(c00)));
+        const __m128i l01 = lumaQ6Sse2(_mm_load_si128(reinterpret_cast<const __m128i *>(c01)));
+        const __m128i l10 = lumaQ6Sse2(_mm_load_si128(reinterpret_cast<const __m128i *>(c10)));
+        const __m128i l11 = lumaQ6Sse2(_mm_load_si128(reinterpret_cast<const __m128i *>(c11)));
+
+        const __m128i f = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(frac + i)),
+                                             _mm_setzero_si128());
+        const __m128i fx = _mm_and_si128(f, interMask);
+        const __m128i fy = _mm_srli_epi32(f, InterBits);
+        const __m128i ifx = _mm_sub_epi32(tab, fx);
+        const __m128i ify = _mm_sub_epi32(tab, fy);
+
+        // 权重不超过 1024，(a, b) 对的乘积用 madd 低 16 位即可算出
+        const __m128i w00 = _mm_madd_epi16(ifx, ify);
+        const __m128i w01 = _mm_madd_epi16(fx, ify);
+        const __m128i w10 = _mm_madd_epi16(ifx, fy);
+        const __m128i w11 = _mm_madd_epi16(fx, fy);
+
+        const __m128i top = _mm_madd_epi16(_mm_or_si128(l00, _mm_slli_epi32(l01, 16)),
+                                           _mm_or_si128(_mm_and_si128(w00, mask16), _mm_slli_epi32(w01, 16)));
+        const __m128i bottom = _mm_madd_epi16(_mm_or_si128(l10, _mm_slli_epi32(l11, 16)),
+                                              _mm_or_si128(_mm_and_si128(w10, mask16), _mm_slli_epi32(w11, 16)));
+        const __m128i v = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(top, bottom), round), 16);
+
+        const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v, v), _mm_setzero_si128());
+        const int32_t out = _mm_cvtsi128_si32(packed);
+        std::memcpy(dst + i, &out, 4);
+    }
+    warpGrayRowScalar(src, xy, frac, dst, i, width);
+}
+#endif
+
+#if defined(SIMD_HAS_AVX2)
+SIMD_TARGET_AVX2
+inline __m256i lumaQ6Avx2(__m256i bgr)
+{
+    const __m256i maskBR = _mm256_set1_epi32(0x00FF00FF);
+    const __m256i maskG = _mm256_set1_epi32(0x000000FF);
+    const __m256i coefBR = _mm256_set1_epi32((CoefR << 16) | CoefB);
+    const __m256i coefG = _mm256_set1_epi32(CoefG);
+    __m256i l = _mm256_add_epi32(_mm256_madd_epi16(_mm256_and_si256(bgr, maskBR), coefBR),
+                                 _mm256_madd_epi16(_mm256_and_si256(_mm256_srli_epi32(bgr, 8), maskG), coefG));
+    return _mm256_srli_epi32(_mm256_add_epi32(l, _mm256_set1_epi32(128)), 8);
+}
+
+// AVX2：8 个像素一组，四个角点用 gather 直接从源图读 32 位（BGR + 下一个字节，后者被掩掉）。
+// gather 会多读一个字节，因此要求 x0 + 2 < width，保证不越过行尾
+SIMD_TARGET_AVX2
+void warpGrayRowAvx2(const SourceImage &src, const int16_t *xy, const uint16_t *frac,
+                     uint8_t *dst, int width)
+{
+    const __m256i mask16 = _mm256_set1_epi32(0xFFFF);
+    const __m256i tab = _mm256_set1_epi32(InterTabSize);
+    const __m256i interMask = _mm256_set1_epi32(InterMask);
+    const __m256i round = _mm256_set1_epi32(1 << 15);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i maxX = _mm256_set1_epi32(src.width - 3);
+    const __m256i maxY = _mm256_set1_epi32(src.height - 2);
+    const __m256i step = _mm256_set1_epi32(int(src.step));
+    const __m256i three = _mm256_set1_epi32(3);
+    const int *base = reinterpret_cast<const int *>(src.data);
+
+    int i = 0;
+    for (; i + 8 <= width; i += 8)
+    {
+        const __m256i pairs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(xy + 2 * i));
+        const __m256i x0 = _mm256_srai_epi32(_mm256_slli_epi32(pairs, 16), 16);
+        const __m256i y0 = _mm256_srai_epi32(pairs, 16);
+
+        // 要求 0 <= x0 <= width - 3，0 <= y0 <= height - 2
+        const __m256i outside = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpgt_epi32(zero, x0), _mm256_cmpgt_epi32(zero, y0)),
+                    _mm256_or_si256(_mm256_cmpgt_epi32(x0, maxX), _mm256_cmpgt_epi32(y0, maxY)));
+        if (!_mm256_testz_si256(outside, outside))
+        {
+            warpGrayRowScalar(src, xy, frac, dst, i, i + 8);
+            continue;
+        }
+
+        const __m256i offset = _mm256_add_epi32(_mm256_mullo_epi32(y0, step), _mm256_mullo_epi32(x0, three));
+        const __m256i offsetBelow = _mm256_add_epi32(offset, step);
+        const __m256i l00 = lumaQ6Avx2(_mm256_i32gather_epi32(base, offset, 1));
+        const __m256i l01 = lumaQ6Avx2(_mm256_i32gather_epi32(base, _mm256_add_epi32(offset, three), 1));
+        const __m256i l10 = lumaQ6Avx2(_mm256_i32gather_epi32(base, offsetBelow, 1));
+        const __m256i l11 = lumaQ6Avx2(_mm256_i32gather_epi32(base, _mm256_add_epi32(offsetBelow, three), 1));
+
+        const __m256i f = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(frac + i)));
+        const __m256i fx = _mm256_and_si256(f, interMask);
+        const __m256i fy = _mm256_srli_epi32(f, InterBits);
+        const __m256i ifx = _mm256_sub_epi32(tab, fx);
+        const __m256i ify = _mm256_sub_epi32(tab, fy);
+
+        const __m256i w00 = _mm256_madd_epi16(ifx, ify);
+        const __m256i w01 = _mm256_madd_epi16(fx, ify);
+        const __m256i w10 = _mm256_madd_epi16(ifx, fy);
+        const __m256i w11 = _mm256_madd_epi16(fx, fy);
+
+        const __m256i top = _mm256_madd_epi16(_mm256_or_si256(l00, _mm256_slli_epi32(l01, 16)),
+                                              _mm256_or_si256(_mm256_and_si256(w00, mask16), _mm256_slli_epi32(w01, 16)));
+        const __m256i bottom = _mm256_madd_epi16(_mm256_or_si256(l10, _mm256_slli_epi32(l11, 16)),
+                                                 _mm256_or_si256(_mm256_and_si256(w10, mask16), _mm256_slli_epi32(w11, 16)));
+        const __m256i v = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(top, bottom), round), 16);
+
+        // packus 在每个 128 位通道内进行，两个通道的低 4 字节分别是像素 0-3 和 4-7
+        const __m256i p16 = _mm256_packus_epi32(v, v);
+        const __m256i p8 = _mm256_packus_epi16(p16, p16);
+        const int32_t lo = _mm256_extract_epi32(p8, 0);
+        const int32_t hi = _mm256_extract_epi32(p8, 4);
+        std::memcpy(dst + i, &lo, 4);
+        std::memcpy(dst + i + 4, &hi, 4);
+    }
+    warpGrayRowScalar(src, xy, frac, dst, i, width);
+}
+#endif
+
+}
+
+void warpGrayRow(const SourceImage &src, const int16_t *xy, const uint16_t *frac,
+                 uint8_t *dst, int width)
+{
+    switch (Simd::activeIsa())
+    {
+#if defined(SIMD_HAS_AVX2)
+    case Simd::IsaAvx2:
+        warpGrayRowAvx2(src, xy, frac, dst, width);
+        return;
+#endif
+#if defined(SIMD_HAS_SSE2)
+    case Simd::IsaSse2:
+        warpGrayRowSse2(src, xy, frac, dst, width);
+        return;
+#endif
+    default:
+        warpGrayRowScalar(src, xy, frac, dst, 0, width);
+        return;
+    }
+}
+
+void warpToGray(const SourceImage &src, const RemapTable &map, uint8_t *dst, size_t dstStep)
+{
+    for (int y = 0; y < map.height; ++y)
+    {
+        const int16_t *xy = reinterpret_cast<const int16_t *>(
+                    reinterpret_cast<const uint8_t *>(map.xy) + y * map.xyStep);
+        const uint16_t *frac = reinterpret_cast<const uint16_t *>(
+                    reinterpret_cast<const uint8_t *>(map.frac) + y * map.fracStep);
+        warpGrayRow(src, xy, frac, dst + y * dstStep, map.width);
+    }
+}
+
+void warpToGrayBlurred(const SourceImage &src, const RemapTable &map,
+                       const BlurEngine::Kernel &kx, const BlurEngine::Kernel &ky,
+                       uint8_t *dst, size_t dstStep)
+{
+    if (map.width <= 0 || map.height <= 0 || kx.size == 0 || ky.size == 0)
+    {
+        return;
+    }
+
+    // 灰度行由映射表现算后直接喂给流式模糊，灰度图本身不落地
+    BlurEngine::SeparableBlur blur(kx, ky, map.width, map.height);
+    blur.run([&](int y, uint8_t *row) {
+        const int16_t *xy = reinterpret_cast<const int16_t *>(
+                    reinterpret_cast<const uint8_t *>(map.xy) + y * map.xyStep);
+        const uint16_t *frac = reinterpret_cast<const uint16_t *>(
+                    reinterpret_cast<const uint8_t *>(map.frac) + y * map.fracStep);
+        warpGrayRow(src, xy, frac, row, map.width);
+    }, dst, dstStep);
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef GRAYWARPKERNEL_H
+#define GRAYWARPKERNEL_H
+
+#include "GaussianBlurEngine.h"
+#include <cstddef>
+#include <cstdint>
+
+// 融合的“透视变换 + 灰度化（+ 高斯模糊）”内核。
+// 直接按 OpenCV 定点映射表（CV_16SC2 + CV_16UC1，INTER_BITS = 5）从 BGR 源图采样，
+// 每个输出像素只读源图一次、只写灰度一次，不产生彩色中间图像。
+// 不依赖 OpenCV 数据结构，SSE2/AVX2 路径由 SimdDispatch 在运行时按 CPU 选择，其余平台走标量实现
+namespace GrayWarp
+{
+
+// BGR 8 位三通道源图
+struct SourceImage
+{
+    const uint8_t *data;
+    int width;
+    int height;
+    size_t step;        // 每行字节数
+};
+
+// 定点映射表：xy 为整数源坐标 (x, y) 对，frac 为 (fy << 5) | fx 插值索引
+struct RemapTable
+{
+    const int16_t *xy;
+    size_t xyStep;      // 每行字节数
+    const uint16_t *frac;
+    size_t fracStep;    // 每行字节数
+    int width;
+    int height;
+};
+
+// 单行：按映射表采样并转灰度。边界外的邻点按 0 处理，与 BORDER_CONSTANT 一致
+void warpGrayRow(const SourceImage &src, const int16_t *xy, const uint16_t *frac,
+                 uint8_t *dst, int width);
+
+// 整幅变换到灰度图
+void warpToGray(const SourceImage &src, const RemapTable &map, uint8_t *dst, size_t dstStep);
+
+// 整幅变换到灰度图并做可分离高斯模糊（边界 BORDER_REFLECT_101），
+// 由 BlurEngine::SeparableBlur 逐行拉取灰度，只保留核高度的几行中间结果
+void warpToGrayBlurred(const SourceImage &src, const RemapTable &map,
+                       const BlurEngine::Kernel &kx, const BlurEngine::Kernel &ky,
+                       uint8_t *dst, size_t dstStep);
+
+}
+
+#endif // GRAYWARPKERNEL_H
@@ -0,0 +1,86 @@
+#include "ImageDecoder.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ImageDecoder
+{
+
+namespace
+{
+// IMREAD_REDUCED_* 支持的缩小倍数，从大到小
+const int Reductions[] = { 8, 4, 2 };
+
+double distance(const cv::Point2f &a, const cv::Point2f &b)
+{
+    return std::hypot(double(a.x - b.x), double(a.y - b.y));
+}
+
+int imreadFlags(int reduction, bool color)
+{
+    switch (reduction)
+    {
+    case 2: return color ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_REDUCED_GRAYSCALE_2;
+    case 4: return color ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_GRAYSCALE_4;
+    case 8: return color ? cv::IMREAD_REDUCED_COLOR_8 : cv::IMREAD_REDUCED_GRAYSCALE_8;
+    default: return color ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE;
+    }
+}
+}
+
+int maxReduction(const std::vector<cv::Point2f> &sourcePoints, const cv::Size &outputSize)
+{
+    if (sourcePoints.size() != 4 || outputSize.width <= 0 || outputSize.height <= 0)
+    {
+        return 1;
+    }
+
+    // 四边形按左上、右上、右下、左下排列；透视下对边长度不同，取较短的一边
+    const double width = std::min(distance(sourcePoints[0], sourcePoints[1]),
+                                  distance(sourcePoints[3], sourcePoints[2]));
+    const double height = std::min(distance(sourcePoints[0], sourcePoints[3]),
+                                   distance(sourcePoints[1], sourcePoints[2]));
+    for (int reduction : Reductions)
+    {
+        if (width / reduction >= outputSize.width && height / reduction >= outputSize.height)
+        {
+            return reduction;
+        }
+    }
+    return 1;
+}
+
+// 缩小后的像素 i 覆盖原图 [i*r, (i+1)*r)，中心在 i*r + (r-1)/2。
+// JPEG 的 DCT 缩放和其他格式解码后的 resize 都是这个对应关系
+cv::Point2f toDecoded(const cv::Point2f &point, int reduction)
+{
+    const float r = float(reduction);
+    return cv::Point2f((point.x + 0.5f) / r - 0.5f, (point.y + 0.5f) / r - 0.5f);
+}
+
+Plan plan(const GaugeParams &params, bool color)
+{
+    Plan p;
+    p.reduction = maxReduction(params.sourcePoints, cv::Size(params.outputWidth, params.outputHeight));
+    p.color = color;
+    p.flags = imreadFlags(p.reduction, color);
+
+    // 只有透视四边形在原图坐标中，其余参数都在透视变换后的坐标中，不受解码尺寸影响。
+    // 不缩小时参数原样保留，配置文件预先放入的映射表仍能命中
+    p.params = params;
+    if (p.reduction == 1)
+    {
+        return p;
+    }
+    for (cv::Point2f &point : p.params.sourcePoints)
+    {
+        point = toDecoded(point, p.reduction);
+    }
+    return p;
+}
+
+cv::Mat decode(const std::string &fileName, const Plan &plan)
+{
+    return cv::imread(fileName, plan.flags);
+}
+
+}
@@ -0,0 +1,37 @@
+#ifndef IMAGEDECODER_H
+#define IMAGEDECODER_H
+
+#include "GaugeCore.h"
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// 按处理需要选择最便宜的解码方式。处理链只用到透视四边形内、缩放到输出尺寸的灰度图，
+// 原图远大于输出图时，用 IMREAD_REDUCED_* 解码：JPEG 在 DCT 域直接按 1/2、1/4、1/8 缩小，
+// 不生成全分辨率图像；不需要彩色透视图时直接解码为灰度，省去色彩转换和三分之二的内存
+namespace ImageDecoder
+{
+
+// 一组参数对应的解码方式，参数不变时对所有图像只算一次
+struct Plan
+{
+    int reduction = 1;              // 解码图相对原图的缩小倍数：1、2、4 或 8
+    bool color = true;
+    int flags = cv::IMREAD_COLOR;   // cv::imread 的标志
+    GaugeParams params;             // 透视四边形换算到解码图坐标后的参数
+};
+
+// color 为 false 时直接解码为灰度（只要读数时）。缩小倍数取不损失精度的最大值
+Plan plan(const GaugeParams &params, bool color = false);
+
+cv::Mat decode(const std::string &fileName, const Plan &plan);
+
+// 透视四边形缩小后各边仍不短于输出图对应边（变换时不需要放大）的最大倍数
+int maxReduction(const std::vector<cv::Point2f> &sourcePoints, const cv::Size &outputSize);
+
+// 原图坐标换算到缩小 reduction 倍的解码图坐标，按像素中心对齐
+cv::Point2f toDecoded(const cv::Point2f &point, int reduction);
+
+}
+
+#endif // IMAGEDECODER_H
@@ -1,29 +1,49 @@
 #include "imageprocessor.h"
 #include <QDebug>
+#include <QFileInfo>
 
 ImageProcessor::ImageProcessor(QObject *parent) : QObject(parent)
-    , m_outputWidth(613)
-    , m_outputHeight(580)
-    , m_sigmaX(2.0)
-    , m_sigmaY(2.0)
-    , m_cannyThreshold1(50)
-    , m_cannyThreshold2(150)
-    , m_minRadius(281)
-    , m_maxRadius(377)
-    , m_rho(1)
-    , m_theta(CV_PI/180)
-    , m_threshold(30)
-    , m_gaugeMinValue(0.0)        // 新增
-    , m_gaugeMaxValue(15.0)        // 新增
-
-{
-    // 初始化默认的透视变换点
-    m_sourcePoints = {
-        cv::Point2f(60, 41),   // 左上
-        cv::Point2f(620, 36),  // 右上
-        cv::Point2f(585, 528), // 右下
-        cv::Point2f(55, 582)   // 左下
-    };
+    , m_sourceId(0)
+    , m_retainedImages(NoImages)
+    , m_worker(nullptr)
+    , m_generation(0)
+    , m_displayedGeneration(0)
+    , m_updateDepth(0)
+    , m_updatePending(false)
+    , m_pendingTrigger("")
+    , m_runCount(0)
+{
+    qRegisterMetaType<GaugeResult>("GaugeResult");
+    qRegisterMetaType<ProcessedFrame>("ProcessedFrame");
+    m_pipeline.setRetainedOutputs(pipelineOutputs());
+}
+
+ImageProcessor::~ImageProcessor()
+{
+    setAsyncEnabled(false);
+}
+
+void ImageProcessor::setAsyncEnabled(bool enabled)
+{
+    if (enabled == isAsyncEnabled())
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        m_worker = new ProcessingWorker(&m_pipeline, &m_pipelineMutex, this);
+        connect(m_worker, &ProcessingWorker::frameReady, this, &ImageProcessor::onFrameReady);
+        m_worker->start();
+    }
+    else
+    {
+        // 停止后台线程，丢弃还没送达的结果
+        m_worker->stop();
+        delete m_worker;
+        m_worker = nullptr;
+        m_displayedGeneration = m_generation;
+    }
 }
 
 bool ImageProcessor::loadImage(const QString &fileName)
@@ -35,285 +55,330 @@ bool ImageProcessor::loadImage(const QString &fileName)
         return false;
     }
 
-    processAll();
+    // 新图像使用新的 sourceId，旧图像的阶段缓存全部失效
+    ++m_sourceId;
+    processAll(__func__);
     return true;
 }
 
-void ImageProcessor::processAll()
+// 各 setter 只修改参数后调用 processAll，由处理链缓存决定哪些阶段需要重新计算
+void ImageProcessor::processAll(const char *trigger)
 {
     if (m_originalImage.empty())
     {
         return;
     }
 
-    applyPerspectiveTransform();
-    convertToGray();
-    applyGaussianBlur();
-    detectEdges();
-    detectCircles();
-    detectLines();
-    analyzeGauge();
-
-    emit processingCompleted();
-}
+    // 事务进行中只做标记，等 endUpdate 时统一处理，计时归到最后一次修改
+    if (m_updateDepth > 0)
+    {
+        m_updatePending = true;
+        m_pendingTrigger = trigger;
+        return;
+    }
 
-// --------------------透视变换--------------------
-void ImageProcessor::applyPerspectiveTransform()
-{
-    if (m_originalImage.empty())
+    // 同步模式下包含整个处理链，异步模式下只是提交请求
+    ScopedTimer timer(trigger);
+    ++m_runCount;
+    if (m_worker)
     {
+        m_worker->submit(m_originalImage, m_sourceId, m_params, ++m_generation, trigger,
+                         m_retainedImages & CircleOverlay, m_retainedImages & LineOverlay);
         return;
     }
 
-    // 计算透视变换矩阵
-    std::vector<cv::Point2f> dstPoints = {
-        cv::Point2f(0, 0),
-        cv::Point2f(m_outputWidth - 1, 0),
-        cv::Point2f(m_outputWidth - 1, m_outputHeight - 1),
-        cv::Point2f(0, m_outputHeight - 1)
-    };
+    {
+        QMutexLocker locker(&m_pipelineMutex);
+        m_pipeline.setSource(m_originalImage, m_sourceId);
+        m_pipeline.run(m_params, m_frame);
+    }
+    m_frame.timings.trigger = trigger;
+    updateOverlays();
+    m_displayedGeneration = ++m_generation;
 
-    cv::Mat transformMatrix = cv::getPerspectiveTransform(m_sourcePoints, dstPoints);
-    cv::warpPerspective(m_originalImage, m_perspectiveTransformResult,
-                        transformMatrix, cv::Size(m_outputWidth, m_outputHeight));
+    emit processingCompleted(m_frame.result);
 }
-void ImageProcessor::setPerspectivePoints(const std::vector<cv::Point2f> &points)
+
+void ImageProcessor::setParameters(const GaugeParams &params)
 {
-    if (points.size() == 4)
-    {
-        m_sourcePoints = points;
-        if (!m_originalImage.empty())
-        {
-            processAll();
-        }
-    }
+    m_params = params;
+    processAll(__func__);
 }
-void ImageProcessor::setOutputSize(int width, int height)
+
+void ImageProcessor::setColorWarpEnabled(bool enabled)
 {
-    m_outputWidth = width;
-    m_outputHeight = height;
-    if (!m_originalImage.empty())
     {
-        processAll();
+        QMutexLocker locker(&m_pipelineMutex);
+        if (m_pipeline.isColorWarpEnabled() == enabled)
+        {
+            return;
+        }
+        m_pipeline.setColorWarpEnabled(enabled);
+        m_pipeline.setRetainedOutputs(pipelineOutputs());
     }
+    processAll(__func__);
 }
 
-
-// --------------------高斯模糊--------------------
-void ImageProcessor::convertToGray()
+void ImageProcessor::setRetainedImages(int images)
 {
-    if (m_perspectiveTransformResult.empty())
+    images &= AllImages;
+    if (images == m_retainedImages)
     {
         return;
     }
+    const bool added = (images & ~m_retainedImages) != 0;
+    m_retainedImages = images;
+    {
+        QMutexLocker locker(&m_pipelineMutex);
+        m_pipeline.setRetainedOutputs(pipelineOutputs());
+    }
 
-    cv::cvtColor(m_perspectiveTransformResult, m_grayImage, cv::COLOR_BGR2GRAY);
-}
-void ImageProcessor::applyGaussianBlur()
-{
-    if (m_grayImage.empty())
+    // 取消订阅的图像立即释放
+    if (!(images & PerspectiveImage)) m_frame.perspective.release();
+    if (!(images & GrayImage)) m_frame.gray.release();
+    if (!(images & BlurredImage)) m_frame.blurred.release();
+    if (!(images & EdgesImage))
     {
-        return;
+        m_frame.edges.release();
+        m_frame.gradients = EdgeGradients();
     }
+    if (!(images & CircleOverlay)) m_circleImage.release();
+    if (!(images & LineOverlay)) m_lineImage.release();
 
-    cv::GaussianBlur(m_grayImage, m_blurredImage, cv::Size(9, 9), m_sigmaX, m_sigmaY);
+    if (added)
+    {
+        processAll(__func__);
+    }
 }
 
-void ImageProcessor::setGaussianSigma(double sigmaX, double sigmaY)
+int ImageProcessor::pipelineOutputs() const
 {
-    m_sigmaX = sigmaX;
-    m_sigmaY = sigmaY;
-    if (!m_originalImage.empty())
+    int outputs = m_retainedImages & GaugePipeline::AllOutputs;
+    if (m_retainedImages & (CircleOverlay | LineOverlay))
     {
-        applyGaussianBlur();
-        detectEdges();
-        detectCircles();
-        detectLines();
-        analyzeGauge();
-
-        emit processingCompleted();
+        outputs |= m_pipeline.isColorWarpEnabled() ? GaugePipeline::PerspectiveOutput : GaugePipeline::GrayOutput;
     }
+    return outputs;
 }
 
-
-// --------------------边缘检测--------------------
-void ImageProcessor::detectEdges()
+MemoryUsage ImageProcessor::memoryUsage() const
 {
-    if (m_blurredImage.empty())
+    MemoryCounter counter;
+    MemoryUsage usage;
     {
-        return;
+        QMutexLocker locker(&m_pipelineMutex);
+        usage = m_pipeline.memoryUsage(counter);
     }
+    usage.source += counter.add(m_originalImage);
+    usage.frame = counter.add(m_frame.perspective) + counter.add(m_frame.gray) + counter.add(m_frame.blurred)
+            + counter.add(m_frame.edges) + counter.add(m_frame.gradients.dx) + counter.add(m_frame.gradients.dy)
+            + counter.add(m_frame.gradients.magnitude);
+    usage.overlays = counter.add(m_circleImage) + counter.add(m_lineImage) + m_overlayPool.bytes(counter);
+    return usage;
+}
 
-    cv::Canny(m_blurredImage, m_edgesImage, m_cannyThreshold1, m_cannyThreshold2);
+void ImageProcessor::setGeometryLockEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_pipelineMutex);
+    m_pipeline.setGeometryLockEnabled(enabled);
 }
 
-void ImageProcessor::setCannyThresholds(int threshold1, int threshold2)
+void ImageProcessor::setNeedleTrackingEnabled(bool enabled)
 {
-    m_cannyThreshold1 = threshold1;
-    m_cannyThreshold2 = threshold2;
-    if (!m_originalImage.empty())
-    {
-        detectEdges();
-        detectCircles();
-        detectLines();
-        analyzeGauge();
+    QMutexLocker locker(&m_pipelineMutex);
+    m_pipeline.setNeedleTrackingEnabled(enabled);
+}
 
-        emit processingCompleted();
-    }
+void ImageProcessor::setGauges(const std::vector<GaugeSpec> &gauges)
+{
+    m_multiGauge.setGauges(gauges);
+    m_gaugeResults.clear();
 }
 
+std::vector<GaugeResult> ImageProcessor::readGauges()
+{
+    m_multiGauge.process(m_originalImage, m_gaugeResults);
+    return m_gaugeResults;
+}
 
-// --------------------霍夫圆检测--------------------
-void ImageProcessor::detectCircles()
+bool ImageProcessor::saveProfile(const QString &fileName)
 {
-    if (m_edgesImage.empty())
+    std::vector<GaugeProfile> profiles;
+    if (m_multiGauge.gaugeCount() > 0)
     {
-        return;
+        profiles = m_multiGauge.profiles(m_gaugeResults);
+    }
+    else
+    {
+        profiles.push_back(GaugeProfile::capture(QFileInfo(fileName).completeBaseName().toStdString(),
+                                                 m_params, m_frame.result));
     }
 
-    std::vector<cv::Vec3f> circles;
-    cv::HoughCircles(m_edgesImage, circles, cv::HOUGH_GRADIENT, 1,
-                     m_edgesImage.rows/16, 100, 30, m_minRadius, m_maxRadius);
-
-    // 清空其他圆，只保留置信度最大的第一个
-    if (!circles.empty()) {m_detectedCircle = circles[0];}
-    x = cvRound(m_detectedCircle[0]);
-    y = cvRound(m_detectedCircle[1]);
-    radius = cvRound(m_detectedCircle[2]);
-
-    // 绘制检测到的圆并进行仪表分析
-    m_circleImage = m_perspectiveTransformResult.clone();
-
-    cv::Point center(x, y);
-    cv::circle(m_circleImage, center, radius, cv::Scalar(0, 0, 255), 2); // 绘制圆周
-    cv::circle(m_circleImage, center, 3, cv::Scalar(0, 255, 0), -1); // 绘制圆心
+    QString error;
+    if (!GaugeProfile::save(fileName, profiles, true, &error))
+    {
+        emit errorOccurred(error);
+        return false;
+    }
+    return true;
 }
 
-void ImageProcessor::setHoughCirclesParams(int minRadius, int maxRadius)
+bool ImageProcessor::loadProfile(const QString &fileName)
 {
-    m_minRadius = minRadius;
-    m_maxRadius = maxRadius;
-    if (!m_originalImage.empty())
+    std::vector<GaugeProfile> profiles;
+    QString error;
+    if (!GaugeProfile::load(fileName, profiles, &error))
     {
-        detectCircles();
-        detectLines();
-        analyzeGauge();
+        emit errorOccurred(error);
+        return false;
+    }
 
-        emit processingCompleted();
+    {
+        QMutexLocker locker(&m_pipelineMutex);
+        m_pipeline.setGeometryLockEnabled(true);
+        profiles.front().warmUp(&m_pipeline.geometryLock());
     }
+    m_multiGauge.setGeometryLockEnabled(true);
+    m_multiGauge.setProfiles(profiles.size() > 1 ? profiles : std::vector<GaugeProfile>());
+    m_gaugeResults.clear();
+
+    setParameters(profiles.front().params);
+    return true;
 }
 
+void ImageProcessor::beginUpdate()
+{
+    ++m_updateDepth;
+}
 
-// --------------------霍夫直线检测--------------------
-void ImageProcessor::detectLines()
+void ImageProcessor::endUpdate()
 {
-    if (m_edgesImage.empty())
+    if (m_updateDepth <= 0)
     {
         return;
     }
 
-    // 创建ROI区域
-    cv::Rect roi(x - radius, y - radius, radius * 2, radius * 2);
-    roi = roi & cv::Rect(0, 0, m_edgesImage.cols, m_edgesImage.rows);
-    if (roi.width <= 0 || roi.height <= 0)
+    if (--m_updateDepth == 0 && m_updatePending)
     {
-        return;
+        m_updatePending = false;
+        processAll(m_pendingTrigger);
     }
+}
 
-    cv::Mat roiImage = m_edgesImage(roi).clone();
-
-    // 检测直线（指针）
-    // HoughLinesP(roiImage, lines, 1, CV_PI/180, 30, radius/2, radius/4);
-    HoughLinesP(roiImage, lines, 1, CV_PI/180, 30, m_minLineLength, m_maxLineGap);
-    // HoughLinesP(roiImage, lines, m_rho, m_theta, m_threshold, m_minLineLength, m_maxLineGap);
-    if (lines.empty())
+void ImageProcessor::onFrameReady(const ProcessedFrame &frame)
+{
+    // 比当前显示内容更旧的结果直接丢弃；比显示内容新但不是最新的结果照常显示，
+    // 这样持续拖动滑块时界面也能不断刷新，最新参数的结果随后送达
+    if (frame.generation <= m_displayedGeneration)
     {
         return;
     }
+    m_displayedGeneration = frame.generation;
 
-    // 找到最长的直线作为指针
-    for (const auto& line : lines)
+    m_frame = frame.frame;
+    m_circleImage = frame.circleImage;
+    m_lineImage = frame.lineImage;
+
+    emit processingCompleted(m_frame.result);
+}
+
+void ImageProcessor::updateOverlays()
+{
+    ScopedTimer timer("overlay");
+    GaugeCore::drawOverlays(m_frame, m_retainedImages & CircleOverlay, m_retainedImages & LineOverlay,
+                            m_circleImage, m_lineImage, &m_overlayPool);
+}
+
+// --------------------透视变换--------------------
+void ImageProcessor::setPerspectivePoints(const std::vector<cv::Point2f> &points)
+{
+    if (points.size() == 4)
     {
-        double length = norm(cv::Point2f(line[0], line[1]) - cv::Point2f(line[2], line[3]));
-        if (length > maxLength)
-        {
-            maxLength = length;
-            m_detectedLine = line;
-        }
+        m_params.sourcePoints = points;
+        processAll(__func__);
     }
+}
+void ImageProcessor::setOutputSize(int width, int height)
+{
+    m_params.outputWidth = width;
+    m_params.outputHeight = height;
+    processAll(__func__);
+}
 
-    m_lineImage=m_circleImage.clone();
 
-    cv::rectangle(m_lineImage, roi, cv::Scalar(255, 255, 0), 2);
-    // 绘制直线
-    // cv::Point pt1(m_detectedLine[0], m_detectedLine[1]);
-    // cv::Point pt2(m_detectedLine[2], m_detectedLine[3]);
+// --------------------高斯模糊--------------------
+void ImageProcessor::setGaussianSigma(double sigmaX, double sigmaY)
+{
+    m_params.sigmaX = sigmaX;
+    m_params.sigmaY = sigmaY;
+    processAll(__func__);
+}
 
-    // 绘制直线（注意坐标转换）
-    cv::Point pt1(m_detectedLine[0] + roi.x, m_detectedLine[1] + roi.y);
-    cv::Point pt2(m_detectedLine[2] + roi.x, m_detectedLine[3] + roi.y);
-    cv::line(m_lineImage, pt1, pt2, cv::Scalar(0, 0, 255), 2); // 红色，线宽2
+void ImageProcessor::setBlurMode(BlurEngine::Mode mode)
+{
+    m_params.blurMode = mode;
+    processAll(__func__);
 }
 
-void ImageProcessor::setHoughLinesParams(int rho,double theta,int threshold,int minLineLength, int maxLineGap)
+
+// --------------------边缘检测--------------------
+void ImageProcessor::setCannyThresholds(int threshold1, int threshold2)
 {
-    m_rho=rho;
-    m_theta=theta;
-    m_threshold=threshold;
-    m_minLineLength = minLineLength;
-    m_maxLineGap = maxLineGap;
-    if (!m_originalImage.empty())
-    {
-        detectLines();
-        analyzeGauge();
+    m_params.cannyThreshold1 = threshold1;
+    m_params.cannyThreshold2 = threshold2;
+    processAll(__func__);
+}
 
-        emit processingCompleted();
-    }
+
+// --------------------霍夫圆检测--------------------
+void ImageProcessor::setHoughCirclesParams(int minRadius, int maxRadius)
+{
+    m_params.minRadius = minRadius;
+    m_params.maxRadius = maxRadius;
+    processAll(__func__);
 }
 
+void ImageProcessor::setCircleMethod(CircleDetector::Method method)
+{
+    m_params.circleMethod = method;
+    processAll(__func__);
+}
 
 
+// --------------------霍夫直线检测--------------------
+void ImageProcessor::setHoughLinesParams(int rho,double theta,int threshold,int minLineLength, int maxLineGap)
+{
+    m_params.rho = rho;
+    m_params.theta = theta;
+    m_params.threshold = threshold;
+    m_params.minLineLength = minLineLength;
+    m_params.maxLineGap = maxLineGap;
+    processAll(__func__);
+}
 
-// --------------------仪表分析--------------------
-void ImageProcessor::analyzeGauge()
+void ImageProcessor::setPointerMethod(PointerDetector::Method method)
 {
-    // 计算指针角度（相对于圆心）
-    cv::Point2f center(radius, radius); // ROI内的相对中心
-    cv::Point2f p1(m_detectedLine[0], m_detectedLine[1]);
-    cv::Point2f p2(m_detectedLine[2], m_detectedLine[3]);
+    m_params.pointerMethod = method;
+    processAll(__func__);
+}
 
-    // 确定哪个端点更接近圆心
-    double dist1 = norm(p1 - center);
-    double dist2 = norm(p2 - center);
-    cv::Point2f pointerTip = (dist1 < dist2) ? p2 : p1;
 
-    // 计算角度（0-360度，0点在右侧，顺时针增加）
-    double angle = atan2(center.y - pointerTip.y, pointerTip.x - center.x) * 180 / CV_PI;
-    if (angle < 0) angle += 360;
 
-    // 转换为实际读数
-    reading = calculateReading(angle, m_gaugeMinValue, m_gaugeMaxValue);
+
+// --------------------仪表分析--------------------
+void ImageProcessor::analyzeGauge()
+{
+    GaugeCore::analyzeGauge(m_params, m_frame.result);
 }
 
 double ImageProcessor::calculateReading(double angle, double minValue, double maxValue)
 {
-    // 假设0度在右侧，270度在顶部（模拟实际仪表）
-    // 调整角度起始位置
-    double adjustedAngle = fmod(angle + 270, 360);
-
-    // 将角度转换为读数
-    double range = maxValue - minValue;
-    double reading = (adjustedAngle / 360.0) * range + minValue;
-
-    return reading;
+    return GaugeCore::calculateReading(angle, minValue, maxValue);
 }
 
 void ImageProcessor::setGaugeRange(double minValue, double maxValue)
 {
-    m_gaugeMinValue = minValue;
-    m_gaugeMaxValue = maxValue;
-
-    analyzeGauge();
-    emit processingCompleted();
+    m_params.gaugeMinValue = minValue;
+    m_params.gaugeMaxValue = maxValue;
+    processAll(__func__);
 }
-
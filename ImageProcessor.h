@@ -3,17 +3,44 @@
 
 #include <QObject>
 #include <opencv2/opencv.hpp>
+#include <QMutex>
+#include "GaugePipeline.h"
+#include "MultiGaugeReader.h"
+#include "ProcessingWorker.h"
 
+Q_DECLARE_METATYPE(GaugeResult)
+
+// GaugeCore 的 Qt 封装：保存当前参数和中间图像，参数变化时增量重新处理并通知界面
 class ImageProcessor : public QObject
 {
     Q_OBJECT
 
 public:
+    // 可订阅的中间图像和结果叠加图，按位组合
+    enum RetainedImage
+    {
+        NoImages = 0,
+        PerspectiveImage = GaugePipeline::PerspectiveOutput,
+        GrayImage = GaugePipeline::GrayOutput,
+        BlurredImage = GaugePipeline::BlurredOutput,
+        EdgesImage = GaugePipeline::EdgesOutput,
+        CircleOverlay = 1 << 4,
+        LineOverlay = 1 << 5,
+        AllImages = PerspectiveImage | GrayImage | BlurredImage | EdgesImage | CircleOverlay | LineOverlay
+    };
+
     explicit ImageProcessor(QObject *parent = nullptr);
+    ~ImageProcessor() override;
+
+    // 异步模式：处理在后台线程进行，连续的参数修改只处理最新一次，
+    // 过期的运行被取消或丢弃，结果通过 processingCompleted 送回界面线程
+    void setAsyncEnabled(bool enabled);
+    bool isAsyncEnabled() const { return m_worker != nullptr; }
 
     // 图像加载和处理
     bool loadImage(const QString &fileName);
-    void processAll();
+    // trigger 为触发处理的操作名（静态字符串），记在计时结果中
+    void processAll(const char *trigger = "processAll");
 
     // 透视变换参数设置
     void setPerspectivePoints(const std::vector<cv::Point2f> &points);
@@ -21,34 +48,86 @@ public:
 
     // 高斯模糊参数设置
     void setGaussianSigma(double sigmaX, double sigmaY);
+    void setBlurMode(BlurEngine::Mode mode);
 
     // Canny边缘检测参数设置
     void setCannyThresholds(int threshold1, int threshold2);
 
     // 霍夫圆检测参数设置
     void setHoughCirclesParams(int minRadius, int maxRadius);
+    void setCircleMethod(CircleDetector::Method method);
 
     // 霍夫直线检测参数设置
     void setHoughLinesParams(int rho,double theta,int threshold,int minLineLength, int maxLineGap);
+    void setPointerMethod(PointerDetector::Method method);
 
     // 仪表分析参数设置
     void setGaugeRange(double minValue, double maxValue);
 
+    // 一次性设置全部参数，只触发一次处理
+    void setParameters(const GaugeParams &params);
+    const GaugeParams &parameters() const { return m_params; }
+
+    // 是否生成彩色透视变换图（供界面显示）。关闭后灰度图由融合内核直接从原图得到
+    void setColorWarpEnabled(bool enabled);
+
+    // 中间图像的保留策略：只有订阅了的图像（例如界面上可见的视图）才保留在处理链缓存中、
+    // 由对应的 get 函数返回，叠加图也只在订阅时绘制；未订阅的阶段算到复用的临时缓冲区，
+    // get 函数返回空图（作为叠加图底图保留的除外）。默认不订阅，只保留原图和读数。新增订阅时重新处理一次
+    void setRetainedImages(int images);
+    int retainedImages() const { return m_retainedImages; }
+
+    // 本实例占用的图像内存（原图、处理链缓存和临时缓冲区、当前结果、叠加图），共享的数据只计一次。
+    // 异步模式下会等待后台线程用完处理链
+    MemoryUsage memoryUsage() const;
+
+    // 固定机位的几何锁定，连续处理同一机位的图像时跳过大部分圆检测
+    void setGeometryLockEnabled(bool enabled);
+    // 指针跟踪，连续处理视频帧时只在预测角附近找指针并平滑读数
+    void setNeedleTrackingEnabled(bool enabled);
+
+    // 多表模式：同一张图上按各表自己的四边形、半径范围和量程并行识别，原图只解码一次。
+    // readGauges 在调用线程中同步处理当前图像，结果顺序与 gauges 相同
+    void setGauges(const std::vector<GaugeSpec> &gauges);
+    const std::vector<GaugeSpec> &gauges() const { return m_multiGauge.gauges(); }
+    std::vector<GaugeResult> readGauges();
+    const std::vector<GaugeResult> &getGaugeResults() const { return m_gaugeResults; }
+    cv::Mat getGaugesImage() const { return m_multiGauge.drawResults(m_originalImage, m_gaugeResults); }
+
+    // 仪表配置文件：参数加上透视映射表、锁定的表盘圆和刻度表。
+    // 设置了多块表时保存全部表，否则保存当前这块表；加载时第一块表成为当前参数，
+    // 文件中有多块表时同时设置多表模式。加载后打开几何锁定，直接从保存的表盘圆开始
+    bool saveProfile(const QString &fileName);
+    bool loadProfile(const QString &fileName);
+
+    // 参数事务：beginUpdate/endUpdate 之间的参数修改和图像加载只在 endUpdate 时处理一次，可嵌套
+    void beginUpdate();
+    void endUpdate();
+    bool isUpdating() const { return m_updateDepth > 0; }
+
+    // 实际运行（或提交到后台线程）处理链的次数
+    quint64 pipelineRunCount() const { return m_runCount; }
+    // 异步模式下后台线程可能正在使用处理链，读取统计信息前需先关闭异步模式
+    const GaugePipeline &pipeline() const { return m_pipeline; }
+
 
     // 获取处理结果
     cv::Mat getOriginalImage() const { return m_originalImage; }
-    cv::Mat getPerspectiveTransformResult() const { return m_perspectiveTransformResult; }
-    cv::Mat getGrayImage() const { return m_grayImage; }
-    cv::Mat getBlurredImage() const { return m_blurredImage; }
-    cv::Mat getEdgesImage() const { return m_edgesImage; }
+    cv::Mat getPerspectiveTransformResult() const { return m_frame.perspective; }
+    cv::Mat getGrayImage() const { return m_frame.gray; }
+    cv::Mat getBlurredImage() const { return m_frame.blurred; }
+    cv::Mat getEdgesImage() const { return m_frame.edges; }
 
     cv::Mat getCirclesImage() const { return m_circleImage; }
     cv::Mat getLineImage() const { return m_lineImage; }
 
-    cv::Vec3f getDetectedCircles() const { return m_detectedCircle; }
-    cv::Vec4i getDetectedLines() const { return m_detectedLine; }
+    cv::Vec3f getDetectedCircles() const { return m_frame.result.circle; }
+    cv::Vec4i getDetectedLines() const { return m_frame.result.pointerLine; }
 
-    double getReading() const { return reading; }
+    double getReading() const { return m_frame.result.reading; }
+    const GaugeResult &getResult() const { return m_frame.result; }
+    // 当前显示结果的各阶段耗时，需先打开 StageTrace
+    const StageTimings &getTimings() const { return m_frame.timings; }
 
     // 获取图像尺寸
     int getImageWidth() const { return m_originalImage.cols; }
@@ -60,60 +139,47 @@ public:
     double calculateReading(double angle, double minValue = 0.0, double maxValue = 1.0);
 
 signals:
-    void processingCompleted();
+    void processingCompleted(const GaugeResult &result);
     void errorOccurred(const QString &errorMessage);
 
+private slots:
+    void onFrameReady(const ProcessedFrame &frame);
+
 private:
-    void applyPerspectiveTransform();
-    void convertToGray();
-    void applyGaussianBlur();
-    void detectEdges();
-    void detectCircles();
-    void detectLines();
+    void updateOverlays();
+    // 处理链需要保留的输出：订阅的图像加上叠加图的底图
+    int pipelineOutputs() const;
 
     // 图像数据
     cv::Mat m_originalImage;
-    cv::Mat m_perspectiveTransformResult;
-    cv::Mat m_grayImage;
-    cv::Mat m_blurredImage;
-    cv::Mat m_edgesImage;
+    GaugeFrame m_frame;
     cv::Mat m_circleImage;
     cv::Mat m_lineImage;
+    FramePool m_overlayPool;    // 同步模式下叠加图的缓冲区
 
     // 处理参数
-    std::vector<cv::Point2f> m_sourcePoints;
-    int m_outputWidth;
-    int m_outputHeight;
-
-    double m_sigmaX;
-    double m_sigmaY;
-
-    int m_cannyThreshold1;
-    int m_cannyThreshold2;
-
-    int m_minRadius;
-    int m_maxRadius;
-
-
-    int m_rho;
-    double m_theta;
-    int m_threshold;
-    int m_minLineLength;
-    int m_maxLineGap;
-
-    // 检测结果
-    std::vector<cv::Vec4i> circles;
-    cv::Vec3f m_detectedCircle;
-
-    int x,y,radius;
-    std::vector<cv::Vec4i> lines;
-    cv::Vec4i m_detectedLine;
-    double maxLength = 0;
-
-    // 仪表量程参数
-    double m_gaugeMinValue;
-    double m_gaugeMaxValue;
-    double reading;
+    GaugeParams m_params;
+
+    // 多表模式
+    MultiGaugeReader m_multiGauge;
+    std::vector<GaugeResult> m_gaugeResults;
+
+    // 带阶段缓存的处理链，m_sourceId 每加载一次图像递增
+    GaugePipeline m_pipeline;
+    uint64_t m_sourceId;
+    int m_retainedImages;
+
+    // 异步处理：m_generation 每次提交递增，m_displayedGeneration 为当前显示结果的代数
+    mutable QMutex m_pipelineMutex;
+    ProcessingWorker *m_worker;
+    quint64 m_generation;
+    quint64 m_displayedGeneration;
+
+    // 参数事务
+    int m_updateDepth;
+    bool m_updatePending;
+    const char *m_pendingTrigger;   // 事务中最后一次修改的操作名
+    quint64 m_runCount;
 };
 
 #endif // IMAGEPROCESSOR_H
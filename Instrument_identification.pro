@@ -17,13 +17,56 @@ DEFINES += QT_DEPRECATED_WARNINGS
 RC_ICONS = img/instrument.ico
 
 SOURCES += \
+    BatchReader.cpp \
+    CircleDetector.cpp \
+    FramePool.cpp \
+    GaugeCore.cpp \
+    GaugePipeline.cpp \
+    GaugeProfile.cpp \
+    GaussianBlurEngine.cpp \
+    GeometryLock.cpp \
+    GrayWarpKernel.cpp \
+    ImageDecoder.cpp \
     ImageProcessor.cpp \
+    MultiGaugeReader.cpp \
+    NeedleTracker.cpp \
+    ParallelCanny.cpp \
+    PerspectiveMap.cpp \
+    PointerDetector.cpp \
+    ProcessingWorker.cpp \
+    SimdDispatch.cpp \
+    StageExecutor.cpp \
+    StageTimer.cpp \
+    StreamReader.cpp \
     main.cpp \
     pixelviewerwidget.cpp \
     widget.cpp
 
 HEADERS += \
+    BatchReader.h \
+    CircleDetector.h \
+    FramePool.h \
+    GaugeCore.h \
+    GaugePipeline.h \
+    GaugeProfile.h \
+    GaussianBlurEngine.h \
+    GeometryLock.h \
+    GrayWarpKernel.h \
+    ImageDecoder.h \
     ImageProcessor.h \
+    MemoryUsage.h \
+    MultiGaugeReader.h \
+    NeedleTracker.h \
+    ParallelCanny.h \
+    PerspectiveMap.h \
+    PointerDetector.h \
+    ProcessingWorker.h \
+    SimdDispatch.h \
+    SpscQueue.h \
+    StageCache.h \
+    StageExecutor.h \
+    StageTimer.h \
+    StreamReader.h \
     pixelviewerwidget.h \
     widget.h
 
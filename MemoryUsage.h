@@ -0,0 +1,37 @@
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <unordered_set>
+
+// 一个实例持有的图像内存（字节），用于估算每个处理实例的占用、确定工作线程数
+struct MemoryUsage
+{
+    size_t source = 0;      // 输入图像
+    size_t cache = 0;       // 阶段缓存中的中间图像
+    size_t scratch = 0;     // 缓冲区池中不在缓存里的部分（未订阅阶段的临时输出、等待复用的空闲缓冲区）
+    size_t frame = 0;       // 当前结果中不与缓存共享的图像
+    size_t overlays = 0;    // 结果叠加图
+
+    size_t total() const { return source + cache + scratch + frame + overlays; }
+};
+
+// 按数据块去重累加 cv::Mat 的字节数：缓存和 frame 中共享同一块数据的 Mat 只计一次
+class MemoryCounter
+{
+public:
+    size_t add(const cv::Mat &mat)
+    {
+        if (mat.empty() || !m_seen.insert(mat.datastart).second)
+        {
+            return 0;
+        }
+        return size_t(mat.dataend - mat.datastart);
+    }
+
+private:
+    std::unordered_set<const uchar *> m_seen;
+};
+
+#endif // MEMORYUSAGE_H
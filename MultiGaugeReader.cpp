@@ -0,0 +1,223 @@
+#include "MultiGaugeReader.h"
+#include <cstdio>
+
+MultiGaugeReader::MultiGaugeReader()
+    : m_lockEnabled(false)
+    , m_trackingEnabled(false)
+{
+}
+
+void MultiGaugeReader::setGauges(const std::vector<GaugeSpec> &gauges)
+{
+    clearGauges();
+    for (const auto &gauge : gauges)
+    {
+        addGauge(gauge);
+    }
+}
+
+void MultiGaugeReader::addGauge(const GaugeSpec &gauge)
+{
+    addGauge(gauge, nullptr);
+}
+
+void MultiGaugeReader::addGauge(const GaugeSpec &gauge, std::shared_ptr<const PerspectiveMap> map)
+{
+    const cv::Size outputSize(gauge.params.outputWidth, gauge.params.outputHeight);
+    if (!map || map->key != PerspectiveMapCache::key(gauge.params.sourcePoints, outputSize))
+    {
+        map = PerspectiveMapCache::instance().get(gauge.params.sourcePoints, outputSize);
+    }
+    m_gauges.push_back(gauge);
+    m_maps.push_back(map);
+    m_locks.emplace_back();
+    m_locks.back().setEnabled(m_lockEnabled);
+    m_trackers.emplace_back();
+    m_trackers.back().setEnabled(m_trackingEnabled);
+    m_pools.emplace_back();
+}
+
+void MultiGaugeReader::clearGauges()
+{
+    m_gauges.clear();
+    m_locks.clear();
+    m_trackers.clear();
+    m_maps.clear();
+    m_pools.clear();
+}
+
+void MultiGaugeReader::setProfiles(const std::vector<GaugeProfile> &profiles)
+{
+    clearGauges();
+    for (const auto &profile : profiles)
+    {
+        GaugeSpec gauge;
+        gauge.name = profile.name;
+        gauge.params = profile.params;
+        // 配置文件中的映射表直接由本表持有，不再构建，也不放入容量有限的全局缓存
+        addGauge(gauge, profile.hasValidWarpMap() ? profile.warpMap : nullptr);
+        if (profile.hasCircle)
+        {
+            m_locks.back().lock(profile.params, profile.circle, profile.circleSupport);
+        }
+    }
+}
+
+std::vector<GaugeProfile> MultiGaugeReader::profiles(const std::vector<GaugeResult> &results) const
+{
+    std::vector<GaugeProfile> profiles;
+    for (size_t i = 0; i < m_gauges.size(); ++i)
+    {
+        profiles.push_back(GaugeProfile::capture(m_gauges[i].name, m_gauges[i].params,
+                                                 i < results.size() ? results[i] : GaugeResult()));
+    }
+    return profiles;
+}
+
+void MultiGaugeReader::setGeometryLockEnabled(bool enabled)
+{
+    m_lockEnabled = enabled;
+    for (auto &lock : m_locks)
+    {
+        lock.setEnabled(enabled);
+    }
+}
+
+void MultiGaugeReader::setNeedleTrackingEnabled(bool enabled)
+{
+    m_trackingEnabled = enabled;
+    for (auto &tracker : m_trackers)
+    {
+        tracker.setEnabled(enabled);
+    }
+}
+
+
+// --------------------处理--------------------
+GaugeResult MultiGaugeReader::processGauge(size_t index, const cv::Mat &image, GaugeFrame *frame)
+{
+    const GaugeParams &params = m_gauges[index].params;
+    const std::shared_ptr<const PerspectiveMap> &map = m_maps[index];
+    GaugeFrame local;
+    GaugeFrame &f = frame ? *frame : local;
+
+    // 与 GaugeCore::process 相同：需要中间图像时分步计算，否则走融合路径。输出都从本表的池中取
+    FramePool &pool = m_pools[index];
+    const cv::Size outputSize(params.outputWidth, params.outputHeight);
+    f.blurred = pool.acquire(outputSize, CV_8UC1);
+    if (frame)
+    {
+        f.perspective = pool.acquire(outputSize, image.type());
+        f.gray = pool.acquire(outputSize, CV_8UC1);
+        GaugeCore::applyPerspectiveTransform(image, f.perspective, params, map);
+        GaugeCore::convertToGray(f.perspective, f.gray);
+        GaugeCore::applyGaussianBlur(f.gray, f.blurred, params);
+    }
+    else
+    {
+        GaugeCore::warpToBlurred(image, f.blurred, params, map);
+    }
+    GaugeCore::acquireEdgeBuffers(pool, outputSize, f.edges, f.gradients);
+    GaugeCore::detectEdges(f.blurred, f.edges, params, &f.gradients);
+
+    GaugeResult result;
+    m_locks[index].detectCircles(f.blurred, f.edges, f.gradients, params, result);
+    m_trackers[index].detectLines(f.edges, f.gradients, params, result);
+    GaugeCore::analyzeGauge(params, result);
+
+    f.result = result;
+    return result;
+}
+
+std::vector<GaugeResult> MultiGaugeReader::process(const cv::Mat &image, std::vector<GaugeFrame> *frames)
+{
+    std::vector<GaugeResult> results;
+    process(image, results, frames);
+    return results;
+}
+
+void MultiGaugeReader::process(const cv::Mat &image, std::vector<GaugeResult> &results,
+                               std::vector<GaugeFrame> *frames)
+{
+    results.assign(m_gauges.size(), GaugeResult());
+    if (frames)
+    {
+        frames->assign(m_gauges.size(), GaugeFrame());
+    }
+    if (image.empty() || m_gauges.empty())
+    {
+        return;
+    }
+
+    // 各表互不依赖，每个任务只写自己的结果和状态。表内的 Canny 再次调用 parallel_for_ 时由 OpenCV 串行执行。
+    // 交给 parallel_for_ 的 lambda 只捕获 task 一个引用，转成 std::function 时不分配堆内存
+    auto task = [&](int i) {
+        results[i] = processGauge(size_t(i), image, frames ? &(*frames)[i] : nullptr);
+    };
+    cv::parallel_for_(cv::Range(0, int(m_gauges.size())), [&task](const cv::Range &range) {
+        for (int i = range.start; i < range.end; ++i)
+        {
+            task(i);
+        }
+    });
+}
+
+
+// --------------------结果绘制--------------------
+cv::Mat MultiGaugeReader::drawResults(const cv::Mat &image, const std::vector<GaugeResult> &results) const
+{
+    if (image.empty())
+    {
+        return cv::Mat();
+    }
+
+    cv::Mat canvas;
+    if (image.channels() == 1)
+    {
+        cv::cvtColor(image, canvas, cv::COLOR_GRAY2BGR);
+    }
+    else
+    {
+        canvas = image.clone();
+    }
+
+    for (size_t i = 0; i < m_gauges.size() && i < results.size(); ++i)
+    {
+        const std::vector<cv::Point2f> &quad = m_gauges[i].params.sourcePoints;
+        if (quad.size() != 4)
+        {
+            continue;
+        }
+
+        // 找到指针为绿色，否则为红色
+        const cv::Scalar color = results[i].isValid() ? cv::Scalar(0, 255, 0) : cv::Scalar(0, 0, 255);
+        std::vector<cv::Point> polygon;
+        for (const auto &pt : quad)
+        {
+            polygon.push_back(cv::Point(cvRound(pt.x), cvRound(pt.y)));
+        }
+        cv::polylines(canvas, polygon, true, color, 2);
+
+        char text[128];
+        if (results[i].isValid())
+        {
+            std::snprintf(text, sizeof(text), "%s %.3f", m_gauges[i].name.c_str(), results[i].reading);
+        }
+        else
+        {
+            std::snprintf(text, sizeof(text), "%s --", m_gauges[i].name.c_str());
+        }
+        cv::putText(canvas, text, polygon[0] + cv::Point(4, 24), cv::FONT_HERSHEY_SIMPLEX, 0.7, color, 2);
+    }
+    return canvas;
+}
+
+uint64_t MultiGaugeReader::poolAllocations() const
+{
+    uint64_t total = 0;
+    for (const auto &pool : m_pools)
+    {
+        total += pool.allocations();
+    }
+    return total;
+}
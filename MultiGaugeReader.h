@@ -0,0 +1,70 @@
+#ifndef MULTIGAUGEREADER_H
+#define MULTIGAUGEREADER_H
+
+#include "GaugeCore.h"
+#include "GaugeProfile.h"
+#include "GeometryLock.h"
+#include "NeedleTracker.h"
+#include "PerspectiveMap.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 一帧中的一块表：独立的透视四边形、半径范围、量程等全部参数
+struct GaugeSpec
+{
+    std::string name;
+    GaugeParams params;
+};
+
+// 多表识别：一个画面中有多块表时，帧只解码一次，各表从同一张原图各自透视变换后并行处理。
+// 每块表有自己的几何锁定和指针跟踪状态，只被处理该表的任务访问；透视映射表在登记时取得并由本表固定持有，
+// 表的数量超过全局 PerspectiveMapCache 的容量时也不会逐帧重建
+class MultiGaugeReader
+{
+public:
+    MultiGaugeReader();
+
+    void setGauges(const std::vector<GaugeSpec> &gauges);
+    void addGauge(const GaugeSpec &gauge);
+    void clearGauges();
+    const std::vector<GaugeSpec> &gauges() const { return m_gauges; }
+    size_t gaugeCount() const { return m_gauges.size(); }
+
+    // 从配置文件设置全部表：映射表放入缓存，保存的表盘圆在打开几何锁定后直接使用
+    void setProfiles(const std::vector<GaugeProfile> &profiles);
+    // 由当前各表参数和对应的识别结果生成配置
+    std::vector<GaugeProfile> profiles(const std::vector<GaugeResult> &results) const;
+
+    // 连续帧（同一机位）时打开，对所有表生效
+    void setGeometryLockEnabled(bool enabled);
+    void setNeedleTrackingEnabled(bool enabled);
+
+    // 处理一帧（BGR），返回与 gauges() 顺序相同的结果。frames 不为空时保留各表的中间图像
+    std::vector<GaugeResult> process(const cv::Mat &image, std::vector<GaugeFrame> *frames = nullptr);
+    // 同上，结果写入调用方持有的 results，视频流逐帧调用时不再为结果数组分配内存
+    void process(const cv::Mat &image, std::vector<GaugeResult> &results, std::vector<GaugeFrame> *frames = nullptr);
+
+    // 在原图上画出各表的四边形和读数
+    cv::Mat drawResults(const cv::Mat &image, const std::vector<GaugeResult> &results) const;
+
+    // 各表缓冲区池新分配的总次数，同尺寸的连续帧预热后保持不变
+    uint64_t poolAllocations() const;
+
+private:
+    // map 为空时从 PerspectiveMapCache 取得（没有时构建）
+    void addGauge(const GaugeSpec &gauge, std::shared_ptr<const PerspectiveMap> map);
+    // 单块表的完整处理，在并行任务中调用
+    GaugeResult processGauge(size_t index, const cv::Mat &image, GaugeFrame *frame);
+
+    std::vector<GaugeSpec> m_gauges;
+    std::vector<GeometryLock> m_locks;
+    std::vector<NeedleTracker> m_trackers;
+    std::vector<std::shared_ptr<const PerspectiveMap>> m_maps;
+    // 每块表一个缓冲区池，只被处理该表的任务访问
+    std::vector<FramePool> m_pools;
+    bool m_lockEnabled;
+    bool m_trackingEnabled;
+};
+
+#endif // MULTIGAUGEREADER_H
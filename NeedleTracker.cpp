@@ -0,0 +1,171 @@
+#include "NeedleTracker.h"
+#include <cmath>
+
+namespace
+{
+// 开始跟踪时角速度的标准差（度/帧）
+const double InitialVelocitySigma = 5.0;
+// 表盘圆移动超过此值（像素）时重新起始跟踪
+const float MaxCircleShift = 2.0f;
+
+inline double normalizeAngle(double angle)
+{
+    angle = std::fmod(angle, 360.0);
+    return angle < 0 ? angle + 360.0 : angle;
+}
+
+// 角度差折算到 (-180, 180]
+inline double angleDifference(double a, double b)
+{
+    double d = std::fmod(a - b, 360.0);
+    if (d <= -180.0) d += 360.0;
+    if (d > 180.0) d -= 360.0;
+    return d;
+}
+}
+
+NeedleTracker::NeedleTracker()
+    : m_enabled(false)
+    , m_tracking(false)
+    , m_angle(0.0)
+    , m_velocity(0.0)
+    , m_minWindow(5.0)
+    , m_maxWindow(45.0)
+    , m_processNoise(0.5)
+    , m_measurementNoise(0.3)
+    , m_windowed(0)
+    , m_fullSearches(0)
+{
+    reset();
+}
+
+void NeedleTracker::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (!enabled)
+    {
+        reset();
+    }
+}
+
+void NeedleTracker::setWindow(double minWindow, double maxWindow)
+{
+    m_minWindow = minWindow;
+    m_maxWindow = std::max(minWindow, maxWindow);
+}
+
+void NeedleTracker::setNoise(double processNoise, double measurementNoise)
+{
+    m_processNoise = processNoise;
+    m_measurementNoise = measurementNoise;
+}
+
+double NeedleTracker::predictedAngle() const
+{
+    return m_tracking ? normalizeAngle(m_angle + m_velocity) : std::numeric_limits<double>::quiet_NaN();
+}
+
+void NeedleTracker::reset()
+{
+    m_tracking = false;
+    m_circle = cv::Vec3f();
+    m_angle = 0.0;
+    m_velocity = 0.0;
+    m_p[0][0] = m_p[0][1] = m_p[1][0] = m_p[1][1] = 0.0;
+}
+
+
+// --------------------卡尔曼滤波--------------------
+void NeedleTracker::start(double angle)
+{
+    m_tracking = true;
+    m_angle = angle;
+    m_velocity = 0.0;
+    m_p[0][0] = m_measurementNoise * m_measurementNoise;
+    m_p[0][1] = m_p[1][0] = 0.0;
+    m_p[1][1] = InitialVelocitySigma * InitialVelocitySigma;
+}
+
+void NeedleTracker::predict()
+{
+    // F = [1 1; 0 1]，Q 为离散白噪声加速度模型
+    const double q = m_processNoise * m_processNoise;
+    m_angle += m_velocity;
+    const double p00 = m_p[0][0] + m_p[0][1] + m_p[1][0] + m_p[1][1] + q / 4;
+    const double p01 = m_p[0][1] + m_p[1][1] + q / 2;
+    const double p11 = m_p[1][1] + q;
+    m_p[0][0] = p00;
+    m_p[0][1] = m_p[1][0] = p01;
+    m_p[1][1] = p11;
+}
+
+void NeedleTracker::update(double angle)
+{
+    // 测量的是回绕到 0-360 的角度，新息按最短角度差计算
+    const double innovation = angleDifference(angle, m_angle);
+    const double s = m_p[0][0] + m_measurementNoise * m_measurementNoise;
+    const double k0 = m_p[0][0] / s;
+    const double k1 = m_p[1][0] / s;
+    m_angle += k0 * innovation;
+    m_velocity += k1 * innovation;
+
+    const double p00 = (1 - k0) * m_p[0][0];
+    const double p01 = (1 - k0) * m_p[0][1];
+    const double p11 = m_p[1][1] - k1 * m_p[0][1];
+    m_p[0][0] = p00;
+    m_p[0][1] = m_p[1][0] = p01;
+    m_p[1][1] = p11;
+}
+
+
+// --------------------指针检测--------------------
+void NeedleTracker::detectLines(const cv::Mat &edges, const EdgeGradients &gradients, const GaugeParams &params,
+                                GaugeResult &result)
+{
+    if (!m_enabled || params.pointerMethod != PointerDetector::PolarMethod || !result.circleFound)
+    {
+        GaugeCore::detectLines(edges, gradients, params, result);
+        if (m_enabled && !result.circleFound)
+        {
+            reset();
+        }
+        return;
+    }
+
+    if (m_tracking && (std::abs(result.circle[0] - m_circle[0]) > MaxCircleShift
+                       || std::abs(result.circle[1] - m_circle[1]) > MaxCircleShift
+                       || std::abs(result.circle[2] - m_circle[2]) > MaxCircleShift))
+    {
+        reset();
+    }
+    m_circle = result.circle;
+
+    if (m_tracking)
+    {
+        predict();
+
+        // 扇区取新息标准差的 3 倍
+        const double sigma = std::sqrt(m_p[0][0] + m_measurementNoise * m_measurementNoise);
+        const double window = std::min(m_maxWindow, std::max(m_minWindow, 3 * sigma));
+        GaugeCore::detectLines(edges, gradients, params, result, normalizeAngle(m_angle), window);
+        if (result.pointerFound)
+        {
+            update(result.pointerAngle);
+            GaugeCore::setPointerAngle(result, normalizeAngle(m_angle));
+            ++m_windowed;
+            return;
+        }
+    }
+
+    // 未跟踪或扇区内丢失：整圈搜索，找到后从该角度重新起始
+    GaugeCore::detectLines(edges, gradients, params, result);
+    ++m_fullSearches;
+    if (result.pointerFound)
+    {
+        start(result.pointerAngle);
+    }
+    else
+    {
+        m_tracking = false;
+    }
+}
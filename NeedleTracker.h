@@ -0,0 +1,60 @@
+#ifndef NEEDLETRACKER_H
+#define NEEDLETRACKER_H
+
+#include "GaugeCore.h"
+#include <cstdint>
+
+// 视频流中的指针跟踪：对指针角度做匀速模型的卡尔曼滤波，预测下一帧的角度，
+// 只在预测角附近的扇区内找指针（PolarMethod），扇区内找不到时当帧改为整圈搜索并重新起始跟踪。
+// 输出的 pointerAngle 为滤波后的角度，读数随之平滑；pointerLine 也转到滤波后的角度，绘制的指针与读数一致
+class NeedleTracker
+{
+public:
+    NeedleTracker();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled; }
+
+    // 搜索扇区半宽 = max(minWindow, 3 倍预测标准差)，不超过 maxWindow（度）
+    void setWindow(double minWindow, double maxWindow);
+    // 过程噪声（角加速度，度/帧²）与测量噪声（度）的标准差
+    void setNoise(double processNoise, double measurementNoise);
+
+    bool isTracking() const { return m_tracking; }
+    // 下一帧的预测角度（度，0-360），未跟踪时为 NaN
+    double predictedAngle() const;
+    void reset();
+
+    // 代替 GaugeCore::detectLines。未启用或不是 PolarMethod 时直接整圈检测；
+    // 表盘圆移动超过 2 像素时重新起始跟踪
+    void detectLines(const cv::Mat &edges, const EdgeGradients &gradients, const GaugeParams &params,
+                     GaugeResult &result);
+
+    // 扇区内找到指针与整圈搜索的次数
+    uint64_t windowedCount() const { return m_windowed; }
+    uint64_t fullSearchCount() const { return m_fullSearches; }
+
+private:
+    void start(double angle);
+    void predict();
+    void update(double angle);
+
+    bool m_enabled;
+    bool m_tracking;
+    cv::Vec3f m_circle;
+
+    // 状态：角度（度，不回绕）与角速度（度/帧），P 为协方差
+    double m_angle;
+    double m_velocity;
+    double m_p[2][2];
+
+    double m_minWindow;
+    double m_maxWindow;
+    double m_processNoise;
+    double m_measurementNoise;
+
+    uint64_t m_windowed;
+    uint64_t m_fullSearches;
+};
+
+#endif // NEEDLETRACKER_H
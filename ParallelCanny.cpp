@@ -0,0 +1,406 @@
+#include "ParallelCanny.h"
+#include "SimdDispatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace ParallelCanny
+{
+
+namespace
+{
+
+// tan(22.5°)，15 位定点（与 OpenCV 相同）
+const int CannyShift = 15;
+const int Tg22 = int(0.4142135623730950488016887242097 * (1 << CannyShift) + 0.5);
+
+// 标记图取值：0 可能是边缘（弱边缘候选），1 不是边缘，2 是边缘
+const uint8_t MaybeEdge = 0;
+const uint8_t NotEdge = 1;
+const uint8_t Edge = 2;
+
+template <typename T>
+inline T *rowPtr(T *base, size_t step, int y)
+{
+    return reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(base) + size_t(y) * step);
+}
+
+template <typename T>
+inline const T *rowPtr(const T *base, size_t step, int y)
+{
+    return reinterpret_cast<const T *>(reinterpret_cast<const uint8_t *>(base) + size_t(y) * step);
+}
+
+// Sobel 的两步：垂直方向 [1 2 1] / [-1 0 1]，水平方向 [-1 0 1] / [1 2 1]。
+// 返回已处理的像素数，剩余部分由标量代码完成
+#if defined(SIMD_HAS_SSE2)
+SIMD_TARGET_SSE2
+int sobelVerticalSse2(const uint8_t *above, const uint8_t *center, const uint8_t *below,
+                      int16_t *smooth, int16_t *diff, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(above + x));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center + x));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(below + x));
+        const __m128i aLo = _mm_unpacklo_epi8(a, zero), aHi = _mm_unpackhi_epi8(a, zero);
+        const __m128i cLo = _mm_unpacklo_epi8(c, zero), cHi = _mm_unpackhi_epi8(c, zero);
+        const __m128i bLo = _mm_unpacklo_epi8(b, zero), bHi = _mm_unpackhi_epi8(b, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(smooth + x),
+                         _mm_add_epi16(_mm_add_epi16(aLo, bLo), _mm_slli_epi16(cLo, 1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(smooth + x + 8),
+                         _mm_add_epi16(_mm_add_epi16(aHi, bHi), _mm_slli_epi16(cHi, 1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(diff + x), _mm_sub_epi16(bLo, aLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(diff + x + 8), _mm_sub_epi16(bHi, aHi));
+    }
+    return x;
+}
+
+// SSE2 没有 abs_epi16，用 max(v, -v)
+SIMD_TARGET_SSE2
+int sobelHorizontalSse2(const int16_t *smooth, const int16_t *diff,
+                        int16_t *dx, int16_t *dy, int16_t *magnitude, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 8 <= width; x += 8)
+    {
+        const __m128i gx = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(smooth + x + 1)),
+                                         _mm_loadu_si128(reinterpret_cast<const __m128i *>(smooth + x - 1)));
+        const __m128i gy = _mm_add_epi16(
+                    _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(diff + x - 1)),
+                                  _mm_loadu_si128(reinterpret_cast<const __m128i *>(diff + x + 1))),
+                    _mm_slli_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(diff + x)), 1));
+        const __m128i mag = _mm_add_epi16(_mm_max_epi16(gx, _mm_sub_epi16(zero, gx)),
+                                          _mm_max_epi16(gy, _mm_sub_epi16(zero, gy)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dx + x), gx);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dy + x), gy);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(magnitude + x), mag);
+    }
+    return x;
+}
+#endif
+
+// 一行 3x3 Sobel，边界复制
+void sobelRow(const Image &src, int y, int16_t *dx, int16_t *dy, int16_t *magnitude,
+              std::vector<int16_t> &smooth, std::vector<int16_t> &diff)
+{
+    const int width = src.width;
+    const uint8_t *above = rowPtr(src.data, src.step, std::max(y - 1, 0));
+    const uint8_t *center = rowPtr(src.data, src.step, y);
+    const uint8_t *below = rowPtr(src.data, src.step, std::min(y + 1, src.height - 1));
+    const bool sse2 = Simd::activeIsa() >= Simd::IsaSse2;
+
+    // smooth/diff 左右各留一个复制边界
+    int16_t *s = smooth.data() + 1;
+    int16_t *d = diff.data() + 1;
+    int x = 0;
+#if defined(SIMD_HAS_SSE2)
+    if (sse2)
+    {
+        x = sobelVerticalSse2(above, center, below, s, d, width);
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        s[x] = int16_t(above[x] + 2 * center[x] + below[x]);
+        d[x] = int16_t(below[x] - above[x]);
+    }
+    s[-1] = s[0];
+    d[-1] = d[0];
+    s[width] = s[width - 1];
+    d[width] = d[width - 1];
+
+    x = 0;
+#if defined(SIMD_HAS_SSE2)
+    if (sse2)
+    {
+        x = sobelHorizontalSse2(s, d, dx, dy, magnitude, width);
+    }
+#endif
+    for (; x < width; ++x)
+    {
+        const int gx = s[x + 1] - s[x - 1];
+        const int gy = d[x - 1] + 2 * d[x] + d[x + 1];
+        dx[x] = int16_t(gx);
+        dy[x] = int16_t(gy);
+        magnitude[x] = int16_t(std::abs(gx) + std::abs(gy));
+    }
+}
+
+// 非极大值抑制 + 双阈值分类，写入标记图的一行；强边缘像素压栈
+void suppressRow(const int *magAbove, const int *mag, const int *magBelow,
+                 const int16_t *dx, const int16_t *dy, int width, int low, int high,
+                 uint8_t *map, std::vector<uint8_t *> &stack)
+{
+    for (int x = 0; x < width; ++x)
+    {
+        const int m = mag[x];
+        if (m > low)
+        {
+            const int xs = dx[x];
+            const int ys = dy[x];
+            const int ax = std::abs(xs);
+            const int ay = std::abs(ys) << CannyShift;
+            const int tg22x = ax * Tg22;
+
+            bool isMax;
+            if (ay < tg22x)
+            {
+                isMax = m > mag[x - 1] && m >= mag[x + 1];
+            }
+            else
+            {
+                const int tg67x = tg22x + (ax << (CannyShift + 1));
+                if (ay > tg67x)
+                {
+                    isMax = m > magAbove[x] && m >= magBelow[x];
+                }
+                else
+                {
+                    const int s = (xs ^ ys) < 0 ? -1 : 1;
+                    isMax = m > magAbove[x - s] && m > magBelow[x + s];
+                }
+            }
+
+            if (isMax)
+            {
+                if (m > high)
+                {
+                    map[x] = Edge;
+                    stack.push_back(map + x);
+                }
+                else
+                {
+                    map[x] = MaybeEdge;
+                }
+                continue;
+            }
+        }
+        map[x] = NotEdge;
+    }
+}
+
+// 从栈中的边缘像素出发，把 8 邻域中的弱边缘候选标为边缘。
+// [begin, end) 限定可修改的标记图范围，块内处理时不越过本块
+void hysteresis(std::vector<uint8_t *> &stack, size_t mapStep, const uint8_t *begin, const uint8_t *end)
+{
+    const ptrdiff_t step = ptrdiff_t(mapStep);
+    const ptrdiff_t offsets[8] = { -step - 1, -step, -step + 1, -1, 1, step - 1, step, step + 1 };
+    while (!stack.empty())
+    {
+        uint8_t *p = stack.back();
+        stack.pop_back();
+        for (ptrdiff_t offset : offsets)
+        {
+            uint8_t *q = p + offset;
+            if (q >= begin && q < end && *q == MaybeEdge)
+            {
+                *q = Edge;
+                stack.push_back(q);
+            }
+        }
+    }
+}
+
+// 工作内存，每个调用线程一份，按图像尺寸和块数只增不减，同尺寸的连续帧不再分配。
+// 块由执行器的工作线程处理，工作线程上的 thread_local 是另一份（空的）实例，
+// 所以调用线程先取出各块缓冲的指针交给块处理，块按块号使用调用线程的那一组
+struct TileBuffers
+{
+    std::vector<int16_t> smooth;
+    std::vector<int16_t> diff;
+    std::vector<int> magRows;
+    std::vector<uint8_t *> stack;
+};
+
+struct Workspace
+{
+    std::vector<int16_t> dx;            // 调用方未提供梯度缓冲时使用
+    std::vector<int16_t> dy;
+    std::vector<int16_t> magnitude;
+    std::vector<uint8_t> map;
+    std::vector<uint8_t *> stack;
+    std::vector<TileBuffers> tiles;
+};
+
+void serialRunner(int count, const std::function<void(int)> &body)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        body(i);
+    }
+}
+
+}
+
+int tileCount(int height, int maxTiles)
+{
+    return std::max(1, std::min(maxTiles, height / MinTileRows));
+}
+
+void detect(const Image &src, double lowThreshold, double highThreshold, const Output &out,
+            int tiles, const TaskRunner &runner)
+{
+    const int width = src.width;
+    const int height = src.height;
+    if (width <= 0 || height <= 0 || !out.edges)
+    {
+        return;
+    }
+
+    if (lowThreshold > highThreshold)
+    {
+        std::swap(lowThreshold, highThreshold);
+    }
+    const int low = int(std::floor(lowThreshold));
+    const int high = int(std::floor(highThreshold));
+
+    const TaskRunner run = runner ? runner : TaskRunner(serialRunner);
+    tiles = std::max(1, std::min(tiles, height));
+
+    thread_local Workspace workspace;
+    if (workspace.tiles.size() < size_t(tiles))
+    {
+        workspace.tiles.resize(size_t(tiles));
+    }
+    // 行缓冲在调用线程上定好尺寸，块处理中只有各块自己的栈可能增长
+    for (int t = 0; t < tiles; ++t)
+    {
+        TileBuffers &buffers = workspace.tiles[size_t(t)];
+        buffers.smooth.resize(std::max(buffers.smooth.size(), size_t(width) + 2));
+        buffers.diff.resize(std::max(buffers.diff.size(), size_t(width) + 2));
+        buffers.magRows.resize(std::max(buffers.magRows.size(), 3 * (size_t(width) + 2)));
+    }
+    TileBuffers *const tileBuffers = workspace.tiles.data();
+
+    // 未提供梯度缓冲时用工作内存
+    const size_t pixels = size_t(width) * height;
+    Output o = out;
+    if (!o.dx)
+    {
+        workspace.dx.resize(std::max(workspace.dx.size(), pixels));
+        o.dx = workspace.dx.data();
+        o.dxStep = size_t(width) * sizeof(int16_t);
+    }
+    if (!o.dy)
+    {
+        workspace.dy.resize(std::max(workspace.dy.size(), pixels));
+        o.dy = workspace.dy.data();
+        o.dyStep = size_t(width) * sizeof(int16_t);
+    }
+    if (!o.magnitude)
+    {
+        workspace.magnitude.resize(std::max(workspace.magnitude.size(), pixels));
+        o.magnitude = workspace.magnitude.data();
+        o.magnitudeStep = size_t(width) * sizeof(int16_t);
+    }
+
+    // 标记图四周各留一圈“不是边缘”，滞后阈值扩展时不必判断越界
+    const size_t mapStep = size_t(width) + 2;
+    const size_t mapSize = mapStep * (height + 2);
+    workspace.map.resize(std::max(workspace.map.size(), mapSize));
+    std::fill(workspace.map.begin(), workspace.map.begin() + mapSize, NotEdge);
+    uint8_t *const mapBegin = workspace.map.data();
+    uint8_t *map = mapBegin + mapStep + 1;
+
+    auto tileBegin = [&](int t) { return int(int64_t(height) * t / tiles); };
+
+    // 各阶段的块处理先写成局部 lambda，交给 run 的只是引用它的单指针包装，
+    // 可以放进 std::function 的内部存储，每次调用不会为捕获列表分配堆内存
+
+    // --------------------梯度--------------------
+    auto gradientTile = [&](int t) {
+        TileBuffers &buffers = tileBuffers[t];
+        for (int y = tileBegin(t); y < tileBegin(t + 1); ++y)
+        {
+            sobelRow(src, y, rowPtr(o.dx, o.dxStep, y), rowPtr(o.dy, o.dyStep, y),
+                     rowPtr(o.magnitude, o.magnitudeStep, y), buffers.smooth, buffers.diff);
+        }
+    };
+    run(tiles, [&gradientTile](int t) { gradientTile(t); });
+
+    // --------------------非极大值抑制 + 块内滞后阈值--------------------
+    // 每块读取上下各一行邻块的幅值（光环行），只修改自己的标记行
+    auto suppressTile = [&](int t) {
+        const int y0 = tileBegin(t);
+        const int y1 = tileBegin(t + 1);
+        TileBuffers &buffers = tileBuffers[t];
+
+        // 幅值行左右各补一个 0，图像外的行全为 0
+        int *magRows = buffers.magRows.data();
+        std::fill(magRows, magRows + 3 * (size_t(width) + 2), 0);
+        int *rows[3] = { magRows + 1, magRows + width + 3, magRows + 2 * (width + 2) + 1 };
+        auto loadMag = [&](int *dst, int y) {
+            if (y < 0 || y >= height)
+            {
+                std::fill(dst, dst + width, 0);
+                return;
+            }
+            const int16_t *m = rowPtr(o.magnitude, o.magnitudeStep, y);
+            std::copy(m, m + width, dst);
+        };
+        loadMag(rows[0], y0 - 1);
+        loadMag(rows[1], y0);
+
+        std::vector<uint8_t *> &stack = buffers.stack;
+        stack.clear();
+        for (int y = y0; y < y1; ++y)
+        {
+            loadMag(rows[2], y + 1);
+            suppressRow(rows[0], rows[1], rows[2], rowPtr(o.dx, o.dxStep, y), rowPtr(o.dy, o.dyStep, y),
+                        width, low, high, map + size_t(y) * mapStep, stack);
+            std::rotate(rows, rows + 1, rows + 3);
+        }
+
+        hysteresis(stack, mapStep, map + size_t(y0) * mapStep - 1, map + size_t(y1) * mapStep - 1);
+    };
+    run(tiles, [&suppressTile](int t) { suppressTile(t); });
+
+    // --------------------跨块补全--------------------
+    // 块边界两侧一边是边缘、另一边是弱边缘候选时，从该点继续在整图范围内扩展
+    std::vector<uint8_t *> &stack = workspace.stack;
+    stack.clear();
+    for (int t = 1; t < tiles; ++t)
+    {
+        const int y = tileBegin(t);
+        uint8_t *above = map + size_t(y - 1) * mapStep;
+        uint8_t *below = map + size_t(y) * mapStep;
+        for (int x = 0; x < width; ++x)
+        {
+            for (int k = -1; k <= 1; ++k)
+            {
+                if (above[x] == Edge && below[x + k] == MaybeEdge)
+                {
+                    below[x + k] = Edge;
+                    stack.push_back(below + x + k);
+                }
+                if (below[x] == Edge && above[x + k] == MaybeEdge)
+                {
+                    above[x + k] = Edge;
+                    stack.push_back(above + x + k);
+                }
+            }
+        }
+    }
+    hysteresis(stack, mapStep, mapBegin, mapBegin + mapSize);
+
+    // --------------------输出--------------------
+    auto outputTile = [&](int t) {
+        for (int y = tileBegin(t); y < tileBegin(t + 1); ++y)
+        {
+            const uint8_t *m = map + size_t(y) * mapStep;
+            uint8_t *e = rowPtr(out.edges, out.edgesStep, y);
+            for (int x = 0; x < width; ++x)
+            {
+                e[x] = m[x] == Edge ? 255 : 0;
+            }
+        }
+    };
+    run(tiles, [&outputTile](int t) { outputTile(t); });
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef PARALLELCANNY_H
+#define PARALLELCANNY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// 按行分块并行的 Canny 边缘检测（3x3 Sobel，L1 梯度幅值，与 cv::Canny 默认参数的规则相同）。
+// 梯度和非极大值抑制按块并行，每块读取上下各一行的邻块数据；
+// 滞后阈值先在块内完成，再从块边界出发串行补全跨块连通的边缘，结果与整图处理一致。
+// 计算过程中得到的 dx/dy/幅值可以输出给后续阶段复用
+namespace ParallelCanny
+{
+
+// 8 位灰度输入
+struct Image
+{
+    const uint8_t *data;
+    int width;
+    int height;
+    size_t step;        // 每行字节数
+};
+
+// 输出缓冲，尺寸与输入相同。edges 必须提供（0/255）；梯度缓冲为空时用调用线程的内部工作内存
+struct Output
+{
+    uint8_t *edges = nullptr;
+    size_t edgesStep = 0;
+    int16_t *dx = nullptr;          // Sobel x，边界 BORDER_REPLICATE
+    size_t dxStep = 0;
+    int16_t *dy = nullptr;          // Sobel y
+    size_t dyStep = 0;
+    int16_t *magnitude = nullptr;   // |dx| + |dy|，最大 2040
+    size_t magnitudeStep = 0;
+};
+
+// 并行执行器：对 [0, count) 中的每个 i 调用 body(i)，可以并发，返回前全部完成。
+// 为空时串行执行
+typedef std::function<void(int count, const std::function<void(int)> &body)> TaskRunner;
+
+// 块数：每块至少 MinTileRows 行，且不超过 maxTiles
+const int MinTileRows = 16;
+int tileCount(int height, int maxTiles);
+
+// lowThreshold/highThreshold 的含义与 cv::Canny 的 threshold1/threshold2 相同（顺序可互换）
+void detect(const Image &src, double lowThreshold, double highThreshold, const Output &out,
+            int tiles, const TaskRunner &runner = TaskRunner());
+
+}
+
+#endif // PARALLELCANNY_H
@@ -0,0 +1,127 @@
+#include "PerspectiveMap.h"
+
+std::shared_ptr<const PerspectiveMap> PerspectiveMap::build(const std::vector<cv::Point2f> &sourcePoints,
+                                                            const cv::Size &outputSize)
+{
+    auto map = std::make_shared<PerspectiveMap>();
+    map->outputSize = outputSize;
+    map->key = PerspectiveMapCache::key(sourcePoints, outputSize);
+    if (sourcePoints.size() != 4 || outputSize.width <= 0 || outputSize.height <= 0)
+    {
+        return map;
+    }
+
+    std::vector<cv::Point2f> dstPoints = {
+        cv::Point2f(0, 0),
+        cv::Point2f(outputSize.width - 1, 0),
+        cv::Point2f(outputSize.width - 1, outputSize.height - 1),
+        cv::Point2f(0, outputSize.height - 1)
+    };
+
+    // 输出像素 -> 源图坐标，使用逆变换
+    cv::Mat inverse = cv::getPerspectiveTransform(dstPoints, sourcePoints);
+    const double *m = inverse.ptr<double>();
+
+    cv::Mat mapX(outputSize, CV_32FC1);
+    cv::Mat mapY(outputSize, CV_32FC1);
+    for (int y = 0; y < outputSize.height; ++y)
+    {
+        float *mx = mapX.ptr<float>(y);
+        float *my = mapY.ptr<float>(y);
+        for (int x = 0; x < outputSize.width; ++x)
+        {
+            const double w = m[6] * x + m[7] * y + m[8];
+            const double iw = w != 0 ? 1.0 / w : 0.0;
+            mx[x] = float((m[0] * x + m[1] * y + m[2]) * iw);
+            my[x] = float((m[3] * x + m[4] * y + m[5]) * iw);
+        }
+    }
+
+    // 转为定点格式，remap 时不再做浮点坐标运算
+    cv::convertMaps(mapX, mapY, map->map1, map->map2, CV_16SC2);
+    return map;
+}
+
+void PerspectiveMap::apply(const cv::Mat &src, cv::Mat &dst) const
+{
+    if (src.empty() || map1.empty())
+    {
+        dst.release();
+        return;
+    }
+
+    cv::remap(src, dst, map1, map2, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+}
+
+
+// --------------------映射表缓存--------------------
+PerspectiveMapCache &PerspectiveMapCache::instance()
+{
+    static PerspectiveMapCache cache(4);
+    return cache;
+}
+
+PerspectiveMapCache::PerspectiveMapCache(size_t capacity)
+    : m_cache(capacity)
+    , m_buildCount(0)
+{
+}
+
+uint64_t PerspectiveMapCache::key(const std::vector<cv::Point2f> &sourcePoints, const cv::Size &outputSize)
+{
+    StageKey key;
+    for (const auto &pt : sourcePoints)
+    {
+        key.add(pt.x).add(pt.y);
+    }
+    key.add(outputSize.width).add(outputSize.height);
+    return key.value();
+}
+
+std::shared_ptr<const PerspectiveMap> PerspectiveMapCache::get(const std::vector<cv::Point2f> &sourcePoints,
+                                                               const cv::Size &outputSize)
+{
+    const uint64_t mapKey = key(sourcePoints, outputSize);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (const auto *cached = m_cache.find(mapKey))
+        {
+            return *cached;
+        }
+    }
+
+    // 在锁外构建，避免阻塞其他几何参数的查找；并发构建同一张表时后插入的覆盖先插入的
+    auto map = PerspectiveMap::build(sourcePoints, outputSize);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_buildCount;
+    return m_cache.insert(mapKey, map);
+}
+
+void PerspectiveMapCache::insert(const std::vector<cv::Point2f> &sourcePoints,
+                                 std::shared_ptr<const PerspectiveMap> map)
+{
+    if (!map)
+    {
+        return;
+    }
+    const uint64_t mapKey = key(sourcePoints, map->outputSize);
+    if (map->key != mapKey)
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.insert(mapKey, map);
+}
+
+void PerspectiveMapCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.clear();
+}
+
+uint64_t PerspectiveMapCache::buildCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_buildCount;
+}
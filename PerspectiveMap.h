@@ -0,0 +1,53 @@
+#ifndef PERSPECTIVEMAP_H
+#define PERSPECTIVEMAP_H
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "StageCache.h"
+
+// 预先编译好的透视变换映射表（定点格式，供 cv::remap 使用）。
+// 对固定机位，四个源点和输出尺寸几乎不变，映射表只需计算一次
+struct PerspectiveMap
+{
+    cv::Size outputSize;
+    uint64_t key = 0;   // 构建时的源点和输出尺寸的散列（PerspectiveMapCache::key）
+    cv::Mat map1;   // CV_16SC2，整数源坐标
+    cv::Mat map2;   // CV_16UC1，插值表索引
+
+    static std::shared_ptr<const PerspectiveMap> build(const std::vector<cv::Point2f> &sourcePoints,
+                                                       const cv::Size &outputSize);
+
+    // 双线性插值、边界填 0，与 cv::warpPerspective 默认行为一致
+    void apply(const cv::Mat &src, cv::Mat &dst) const;
+};
+
+// 线程安全的映射表缓存，按“源点 + 输出尺寸”查找，多个工作线程共享
+class PerspectiveMapCache
+{
+public:
+    static PerspectiveMapCache &instance();
+
+    std::shared_ptr<const PerspectiveMap> get(const std::vector<cv::Point2f> &sourcePoints,
+                                              const cv::Size &outputSize);
+
+    // 放入预先算好的映射表（例如从仪表配置文件加载），之后的 get 不再重新构建；
+    // map->key 与 sourcePoints 和 map->outputSize 不符时不放入
+    void insert(const std::vector<cv::Point2f> &sourcePoints, std::shared_ptr<const PerspectiveMap> map);
+
+    void clear();
+    uint64_t buildCount() const;
+
+    // 缓存键，也随映射表保存到配置文件中，加载时校验映射表与参数是否对应
+    static uint64_t key(const std::vector<cv::Point2f> &sourcePoints, const cv::Size &outputSize);
+
+private:
+    explicit PerspectiveMapCache(size_t capacity);
+
+    mutable std::mutex m_mutex;
+    StageCache<std::shared_ptr<const PerspectiveMap>> m_cache;
+    uint64_t m_buildCount;
+};
+
+#endif // PERSPECTIVEMAP_H
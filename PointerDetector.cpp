@@ -0,0 +1,301 @@
+#include "PointerDetector.h"
+#include "GaugeCore.h"
+#include <cmath>
+
+namespace PointerDetector
+{
+
+namespace
+{
+// 梯度与径向夹角的余弦超过此值的边缘视为圆弧（表盘外圈、刻度弧），不参与指针检测
+const float RadialCosine = 0.9f;
+// 径向上允许的最大空隙（相对表盘半径），指针上的文字、反光会打断边缘
+const float MaxGapRatio = 0.1f;
+// 指针半宽上限（相对表盘半径，至少 MinHalfWidth 像素）
+const float HalfWidthRatio = 0.03f;
+const float MinHalfWidth = 3.0f;
+
+inline int wrapBin(int bin, int bins)
+{
+    bin %= bins;
+    return bin < 0 ? bin + bins : bin;
+}
+
+// 展开图的行数（每行 1 像素的半径）
+int ringRows(float radius)
+{
+    return std::max(0, int(radius * OuterRadiusRatio - radius * InnerRadiusRatio) + 1);
+}
+
+// 展开图放在每个线程复用的缓冲区中。表盘半径逐帧会有一两个像素的变化，
+// 缓冲区只增不减、取左上角的子区域，尺寸变化时也不重新分配
+cv::Mat polarBuffer(int rows, int cols)
+{
+    thread_local cv::Mat buffer;
+    if (buffer.rows < rows || buffer.cols < cols)
+    {
+        buffer.create(std::max(buffer.rows, rows), std::max(buffer.cols, cols), CV_8UC1);
+    }
+    return buffer(cv::Rect(0, 0, cols, rows));
+}
+
+// 在展开图上找指针。wrap 为 true 时 polarImage 覆盖整圈，平滑窗口循环取值；
+// 否则只在窗口内部找，贴着两端的峰值不可靠，视为未找到
+Detection findPointer(const cv::Mat &polarImage, int bins, int firstBin, float innerRadius,
+                      float radius, int minLength, bool wrap)
+{
+    Detection detection;
+    const int columns = polarImage.cols;
+    if (polarImage.rows == 0 || columns < 3)
+    {
+        return detection;
+    }
+
+    // 列求和；求和与平滑结果放在每个线程复用的数组中
+    thread_local std::vector<int> sums;
+    sums.assign(size_t(columns), 0);
+    for (int row = 0; row < polarImage.rows; ++row)
+    {
+        const uchar *p = polarImage.ptr<uchar>(row);
+        for (int k = 0; k < columns; ++k)
+        {
+            sums[k] += p[k];
+        }
+    }
+    const int *profile = sums.data();
+
+    // 按约 ±1 度的窗口平滑，压掉零散边缘形成的单列尖峰
+    const int half = std::max(1, bins / 360);
+    thread_local std::vector<int> smoothed;
+    smoothed.assign(size_t(columns), 0);
+    for (int k = 0; k < columns; ++k)
+    {
+        int sum = 0;
+        for (int d = -half; d <= half; ++d)
+        {
+            const int j = k + d;
+            if (wrap)
+            {
+                sum += profile[wrapBin(j, columns)];
+            }
+            else if (j >= 0 && j < columns)
+            {
+                sum += profile[j];
+            }
+        }
+        smoothed[k] = sum;
+    }
+
+    int peak = 0;
+    for (int k = 1; k < columns; ++k)
+    {
+        if (smoothed[k] > smoothed[peak])
+        {
+            peak = k;
+        }
+    }
+    if (smoothed[peak] == 0 || (!wrap && (peak == 0 || peak == columns - 1)))
+    {
+        return detection;
+    }
+
+    // 抛物线插值得到初始角度（弧度）
+    const double left = smoothed[wrap ? wrapBin(peak - 1, columns) : peak - 1];
+    const double centre = smoothed[peak];
+    const double right = smoothed[wrap ? wrapBin(peak + 1, columns) : peak + 1];
+    const double denom = left - 2 * centre + right;
+    const double delta = denom < 0 ? 0.5 * (left - right) / denom : 0.0;
+    const double binAngle = 2 * CV_PI / bins;
+    double angle = (firstBin + peak + delta) * binAngle;
+
+    // 平滑窗口按角度取，而指针两侧边缘在内圈张开的角度更大，峰值往往落在某一侧边缘上。
+    // 取指针宽度范围内所有边缘采样点的位置矢量之和，两侧对称抵消后方向即为指针中线
+    const float halfWidth = std::max(MinHalfWidth, radius * HalfWidthRatio);
+    for (int iteration = 0; iteration < 2; ++iteration)
+    {
+        const double center = angle / binAngle - firstBin;
+        double sumX = 0.0;
+        double sumY = 0.0;
+        for (int row = 0; row < polarImage.rows; ++row)
+        {
+            const float r = innerRadius + row;
+            const int span = int(std::ceil(halfWidth / std::max(1.0f, r) / binAngle));
+            const int from = int(std::floor(center)) - span;
+            const uchar *p = polarImage.ptr<uchar>(row);
+            for (int j = from; j <= from + 2 * span + 1; ++j)
+            {
+                if ((!wrap && (j < 0 || j >= columns)) || !p[wrap ? wrapBin(j, columns) : j])
+                {
+                    continue;
+                }
+                const double a = (firstBin + j) * binAngle;
+                sumX += r * std::cos(a);
+                sumY += r * std::sin(a);
+            }
+        }
+        if (sumX == 0.0 && sumY == 0.0)
+        {
+            return detection;
+        }
+        // atan2 的结果在 (-pi, pi]，折算到当前角度附近，保证列号与展开图一致
+        angle += std::remainder(std::atan2(sumY, sumX) - angle, 2 * CV_PI);
+    }
+
+    // 中线两侧指针宽度内的径向覆盖：从内圈向外，空隙超过 maxGap 时停止
+    const double center = angle / binAngle - firstBin;
+    const int maxGap = std::max(3, int(radius * MaxGapRatio));
+    int first = -1;
+    int last = -1;
+    int support = 0;
+    int gap = 0;
+    for (int row = 0; row < polarImage.rows; ++row)
+    {
+        const float r = innerRadius + row;
+        const int span = int(std::ceil(halfWidth / std::max(1.0f, r) / binAngle));
+        const int nearest = int(std::floor(center + 0.5));
+        const uchar *p = polarImage.ptr<uchar>(row);
+        bool hit = false;
+        for (int j = nearest - span; j <= nearest + span && !hit; ++j)
+        {
+            if (wrap)
+            {
+                hit = p[wrapBin(j, columns)] != 0;
+            }
+            else if (j >= 0 && j < columns)
+            {
+                hit = p[j] != 0;
+            }
+        }
+
+        if (hit)
+        {
+            if (first < 0) first = row;
+            last = row;
+            ++support;
+            gap = 0;
+        }
+        else if (first >= 0 && ++gap > maxGap)
+        {
+            break;
+        }
+    }
+
+    if (first < 0 || last - first + 1 < std::min(minLength, polarImage.rows / 2))
+    {
+        return detection;
+    }
+
+    double degrees = std::fmod(angle * 180 / CV_PI, 360.0);
+    if (degrees < 0) degrees += 360.0;
+
+    detection.found = true;
+    detection.angle = degrees;
+    detection.innerRadius = innerRadius + first;
+    detection.outerRadius = innerRadius + last;
+    detection.score = double(support) / polarImage.rows;
+    return detection;
+}
+}
+
+int angleBins(float radius)
+{
+    return std::max(360, int(std::ceil(2 * CV_PI * radius * OuterRadiusRatio)));
+}
+
+
+// --------------------极坐标展开--------------------
+void unwrap(const cv::Mat &edges, const EdgeGradients &gradients, const cv::Vec3f &circle,
+            int bins, int firstBin, int binCount, cv::Mat &polar)
+{
+    const float innerRadius = circle[2] * InnerRadiusRatio;
+    const int rows = ringRows(circle[2]);
+    polar.create(rows, std::max(0, binCount), CV_8UC1);
+    if (rows == 0 || binCount <= 0 || bins <= 0 || edges.empty())
+    {
+        polar.setTo(cv::Scalar(0));
+        return;
+    }
+
+    // 角度按图像坐标系 y 轴向上计算，与 GaugeResult::angle 一致。三角函数表每个线程复用
+    thread_local std::vector<float> cosTable;
+    thread_local std::vector<float> sinTable;
+    cosTable.resize(size_t(binCount));
+    sinTable.resize(size_t(binCount));
+    for (int j = 0; j < binCount; ++j)
+    {
+        const double a = 2 * CV_PI * wrapBin(firstBin + j, bins) / bins;
+        cosTable[j] = float(std::cos(a));
+        sinTable[j] = float(std::sin(a));
+    }
+
+    const bool withGradients = !gradients.empty() && gradients.dx.size() == edges.size();
+    const float cos2 = RadialCosine * RadialCosine;
+    for (int i = 0; i < rows; ++i)
+    {
+        const float r = innerRadius + i;
+        uchar *out = polar.ptr<uchar>(i);
+        for (int j = 0; j < binCount; ++j)
+        {
+            const int x = cvRound(circle[0] + r * cosTable[j]);
+            const int y = cvRound(circle[1] - r * sinTable[j]);
+            if (x < 0 || y < 0 || x >= edges.cols || y >= edges.rows || !edges.ptr<uchar>(y)[x])
+            {
+                out[j] = 0;
+                continue;
+            }
+            if (!withGradients)
+            {
+                out[j] = 1;
+                continue;
+            }
+
+            // 径向在图像坐标中为 (cos, -sin)
+            const float gx = gradients.dx.ptr<int16_t>(y)[x];
+            const float gy = gradients.dy.ptr<int16_t>(y)[x];
+            const float radial = cosTable[j] * gx - sinTable[j] * gy;
+            out[j] = radial * radial <= cos2 * (gx * gx + gy * gy) ? 1 : 0;
+        }
+    }
+}
+
+
+// --------------------整圈搜索--------------------
+Detection polar(const cv::Mat &edges, const EdgeGradients &gradients, const cv::Vec3f &circle,
+                int minLength)
+{
+    if (edges.empty() || circle[2] <= 0)
+    {
+        return Detection();
+    }
+
+    const int bins = angleBins(circle[2]);
+    cv::Mat polarImage = polarBuffer(ringRows(circle[2]), bins);
+    unwrap(edges, gradients, circle, bins, 0, bins, polarImage);
+    return findPointer(polarImage, bins, 0, circle[2] * InnerRadiusRatio, circle[2], minLength, true);
+}
+
+
+// --------------------扇区搜索--------------------
+Detection polarWindow(const cv::Mat &edges, const EdgeGradients &gradients, const cv::Vec3f &circle,
+                      int minLength, double centerAngle, double halfWidth)
+{
+    if (edges.empty() || circle[2] <= 0)
+    {
+        return Detection();
+    }
+
+    const int bins = angleBins(circle[2]);
+    const int halfBins = int(std::ceil(halfWidth * bins / 360.0));
+    if (2 * halfBins + 1 >= bins)
+    {
+        return polar(edges, gradients, circle, minLength);
+    }
+
+    const int centerBin = int(std::floor(centerAngle * bins / 360.0 + 0.5));
+    const int firstBin = centerBin - halfBins;
+    cv::Mat polarImage = polarBuffer(ringRows(circle[2]), 2 * halfBins + 1);
+    unwrap(edges, gradients, circle, bins, firstBin, 2 * halfBins + 1, polarImage);
+    return findPointer(polarImage, bins, firstBin, circle[2] * InnerRadiusRatio, circle[2], minLength, false);
+}
+
+}
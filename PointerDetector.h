@@ -0,0 +1,52 @@
+#ifndef POINTERDETECTOR_H
+#define POINTERDETECTOR_H
+
+#include <opencv2/opencv.hpp>
+
+struct EdgeGradients;
+
+// 指针检测。指针总是穿过表盘圆心，把圆心周围的环带展开成“半径 x 角度”的极坐标图后，
+// 指针就是一列竖线，按列求和即可找到，代价为 O(角度采样数 x 半径采样数)
+namespace PointerDetector
+{
+
+enum Method
+{
+    HoughMethod,    // ROI 内 cv::HoughLinesP，取最长线段
+    PolarMethod     // 极坐标展开后按列求和
+};
+
+// 环带内外半径与表盘半径之比：内圈避开圆心处的轴帽，外圈避开刻度
+const float InnerRadiusRatio = 0.15f;
+const float OuterRadiusRatio = 0.85f;
+
+struct Detection
+{
+    bool found = false;
+    double angle = 0.0;         // 度，0-360，0 点在右侧、逆时针增加（与 GaugeResult::angle 相同）
+    float innerRadius = 0.0f;   // 指针边缘在径向上的覆盖范围
+    float outerRadius = 0.0f;
+    double score = 0.0;         // 峰值列附近有指针边缘的半径采样比例，0-1
+};
+
+// 展开时的角度采样数：外圈上相邻采样点相距不超过 1 像素，至少 360
+int angleBins(float radius);
+
+// 把 circle 周围的环带展开成极坐标图 polar（CV_8UC1，取值 0/1）。
+// 第 i 行为半径 InnerRadiusRatio * r + i（每行 1 像素），第 j 列为第 (firstBin + j) % bins 个角度采样。
+// gradients 不为空时只保留梯度与径向接近垂直的边缘（沿径向延伸的线条），表盘外圈和刻度圆弧被去掉
+void unwrap(const cv::Mat &edges, const EdgeGradients &gradients, const cv::Vec3f &circle,
+            int bins, int firstBin, int binCount, cv::Mat &polar);
+
+// 展开整个环带并按列求和，平滑后取最大的列，再用指针宽度内边缘点位置矢量之和的方向作为指针中线（亚度级）。
+// 指针边缘在径向上连续覆盖的长度小于 minLength（不超过环带宽度的一半）时视为未找到
+Detection polar(const cv::Mat &edges, const EdgeGradients &gradients, const cv::Vec3f &circle,
+                int minLength);
+
+// 只展开 centerAngle ± halfWidth 度的扇区，其余同 polar。峰值贴在扇区边缘时视为未找到（指针可能在扇区外）
+Detection polarWindow(const cv::Mat &edges, const EdgeGradients &gradients, const cv::Vec3f &circle,
+                      int minLength, double centerAngle, double halfWidth);
+
+}
+
+#endif // POINTERDETECTOR_H
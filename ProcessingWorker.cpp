@@ -0,0 +1,109 @@
+#include "ProcessingWorker.h"
+
+ProcessingWorker::ProcessingWorker(GaugePipeline *pipeline, QMutex *pipelineMutex, QObject *parent)
+    : QThread(parent)
+    , m_pipeline(pipeline)
+    , m_pipelineMutex(pipelineMutex)
+    , m_hasPending(false)
+    , m_stopping(false)
+    , m_latestGeneration(0)
+    , m_dropped(0)
+{
+}
+
+ProcessingWorker::~ProcessingWorker()
+{
+    stop();
+}
+
+void ProcessingWorker::submit(const cv::Mat &source, quint64 sourceId, const GaugeParams &params, quint64 generation,
+                              const char *trigger, bool circleOverlay, bool lineOverlay)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_hasPending)
+    {
+        // 上一个请求还没开始处理，直接被新参数覆盖
+        ++m_dropped;
+    }
+    m_pending.source = source;
+    m_pending.sourceId = sourceId;
+    m_pending.params = params;
+    m_pending.generation = generation;
+    m_pending.trigger = trigger;
+    m_pending.circleOverlay = circleOverlay;
+    m_pending.lineOverlay = lineOverlay;
+    m_hasPending = true;
+    m_latestGeneration = generation;
+    m_condition.wakeOne();
+}
+
+void ProcessingWorker::stop()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_condition.wakeOne();
+    }
+    wait();
+}
+
+void ProcessingWorker::run()
+{
+    forever
+    {
+        Request request;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_hasPending && !m_stopping)
+            {
+                m_condition.wait(&m_mutex);
+            }
+            if (m_stopping)
+            {
+                return;
+            }
+            request = m_pending;
+            m_pending = Request();
+            m_hasPending = false;
+        }
+
+        // 正在退出，或已有更新的请求且界面刚刷新过时，当前请求作废
+        auto cancelled = [this, &request]() {
+            if (m_stopping)
+            {
+                return true;
+            }
+            const bool superseded = m_latestGeneration.load() != request.generation;
+            return superseded && m_sinceLastFrame.isValid()
+                    && m_sinceLastFrame.elapsed() < FrameIntervalMs;
+        };
+
+        ProcessedFrame processed;
+        processed.generation = request.generation;
+        {
+            QMutexLocker locker(m_pipelineMutex);
+            m_pipeline->setSource(request.source, request.sourceId);
+            m_pipeline->run(request.params, processed.frame, cancelled);
+            if (m_pipeline->lastRunCancelled())
+            {
+                ++m_dropped;
+                continue;
+            }
+        }
+
+        processed.frame.timings.trigger = request.trigger;
+
+        // 结果叠加图也在后台线程绘制，界面线程只负责显示
+        ScopedTimer overlayTimer("overlay");
+        GaugeCore::drawOverlays(processed.frame, request.circleOverlay, request.lineOverlay,
+                                processed.circleImage, processed.lineImage, &m_overlayPool);
+        overlayTimer.stop();
+        if (cancelled())
+        {
+            ++m_dropped;
+            continue;
+        }
+        m_sinceLastFrame.start();
+        emit frameReady(processed);
+    }
+}
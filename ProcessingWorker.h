@@ -0,0 +1,78 @@
+#ifndef PROCESSINGWORKER_H
+#define PROCESSINGWORKER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QMetaType>
+#include <QElapsedTimer>
+#include <atomic>
+#include "GaugePipeline.h"
+
+// 后台线程处理完成的一帧
+struct ProcessedFrame
+{
+    quint64 generation = 0;
+    GaugeFrame frame;
+    cv::Mat circleImage;
+    cv::Mat lineImage;
+};
+Q_DECLARE_METATYPE(ProcessedFrame)
+
+// 后台处理线程。待处理请求只保留最新一份（新请求直接覆盖旧请求）。
+// 正在运行的请求在每个阶段之间检查是否已过期：界面在一帧时间内刚刷新过时直接放弃，
+// 否则先跑完送去显示，避免持续拖动滑块时一直取消、界面得不到任何结果
+class ProcessingWorker : public QThread
+{
+    Q_OBJECT
+
+public:
+    ProcessingWorker(GaugePipeline *pipeline, QMutex *pipelineMutex, QObject *parent = nullptr);
+    ~ProcessingWorker() override;
+
+    // trigger 为静态字符串，原样记入结果的 timings.trigger；只绘制订阅了的叠加图
+    void submit(const cv::Mat &source, quint64 sourceId, const GaugeParams &params, quint64 generation,
+                const char *trigger = "", bool circleOverlay = true, bool lineOverlay = true);
+    void stop();
+
+    // 被新请求覆盖或中途取消的请求数
+    quint64 droppedCount() const { return m_dropped.load(); }
+
+signals:
+    void frameReady(const ProcessedFrame &frame);
+
+protected:
+    void run() override;
+
+private:
+    struct Request
+    {
+        cv::Mat source;
+        quint64 sourceId = 0;
+        GaugeParams params;
+        quint64 generation = 0;
+        const char *trigger = "";
+        bool circleOverlay = true;
+        bool lineOverlay = true;
+    };
+
+    GaugePipeline *m_pipeline;
+    QMutex *m_pipelineMutex;
+
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+    Request m_pending;
+    bool m_hasPending;
+    std::atomic<bool> m_stopping;
+
+    std::atomic<quint64> m_latestGeneration;
+    std::atomic<quint64> m_dropped;
+
+    // 距上次送出结果的时间，只在工作线程中访问
+    QElapsedTimer m_sinceLastFrame;
+    // 叠加图的缓冲区池，只在工作线程中取用；界面换上新结果后旧叠加图回到池中
+    FramePool m_overlayPool;
+    static const int FrameIntervalMs = 16;
+};
+
+#endif // PROCESSINGWORKER_H
@@ -0,0 +1,53 @@
+#include "SimdDispatch.h"
+#include <algorithm>
+#include <atomic>
+
+namespace Simd
+{
+
+namespace
+{
+std::atomic<int> g_forcedIsa(-1);
+
+Isa detectIsa()
+{
+#if defined(SIMD_X86_DISPATCH)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return IsaAvx2;
+    }
+    return __builtin_cpu_supports("sse2") ? IsaSse2 : IsaScalar;
+#elif defined(SIMD_HAS_AVX2)
+    return IsaAvx2;
+#elif defined(SIMD_HAS_SSE2)
+    return IsaSse2;
+#else
+    return IsaScalar;
+#endif
+}
+}
+
+Isa activeIsa()
+{
+    static const Isa detected = detectIsa();
+    const int forced = g_forcedIsa.load();
+    return forced >= 0 ? Isa(std::min<int>(forced, detected)) : detected;
+}
+
+void forceIsa(int isa)
+{
+    g_forcedIsa = isa;
+}
+
+const char *isaName(Isa isa)
+{
+    switch (isa)
+    {
+    case IsaAvx2: return "avx2";
+    case IsaSse2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+}
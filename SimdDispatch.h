@@ -0,0 +1,41 @@
+#ifndef SIMDDISPATCH_H
+#define SIMDDISPATCH_H
+
+// 运行时指令集选择。GCC/Clang 在 x86 上用 target 属性编译 SSE2/AVX2 版本的函数，
+// 运行时按 CPU 支持情况选择；MSVC 只能按编译选项（/arch:AVX2）决定是否启用 AVX2
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86_DISPATCH 1
+#define SIMD_HAS_SSE2 1
+#define SIMD_HAS_AVX2 1
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define SIMD_HAS_SSE2 1
+#if defined(__AVX2__)
+#define SIMD_HAS_AVX2 1
+#endif
+#define SIMD_TARGET_SSE2
+#define SIMD_TARGET_AVX2
+#include <immintrin.h>
+#endif
+
+namespace Simd
+{
+
+enum Isa
+{
+    IsaScalar,
+    IsaSse2,
+    IsaAvx2
+};
+
+// 当前 CPU 上实际使用的指令集
+Isa activeIsa();
+// 强制使用不高于 isa 的指令集（用于对比测试和基准），传 -1 恢复自动选择
+void forceIsa(int isa);
+const char *isaName(Isa isa);
+
+}
+
+#endif // SIMDDISPATCH_H
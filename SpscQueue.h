@@ -0,0 +1,79 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// 单生产者单消费者的无锁有界环形队列。
+// tryPush 只能在一个线程调用，tryPop 只能在另一个线程调用；size 可在任意线程读取（近似值）
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+        : m_slots((capacity ? capacity : 1) + 1)
+        , m_head(0)
+        , m_tail(0)
+    {
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    // 队列满时返回 false，value 保持不变；成功时 value 被移走
+    bool tryPush(T &value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t next = increment(tail);
+        if (next == m_head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        m_slots[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // 队列空时返回 false
+    bool tryPop(T &value)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        value = std::move(m_slots[head]);
+        // 槽位里剩下的对象立即释放（例如 cv::Mat 的引用），不等到被覆盖
+        m_slots[head] = T();
+        m_head.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        const size_t head = m_head.load(std::memory_order_acquire);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : tail + m_slots.size() - head;
+    }
+
+    size_t capacity() const { return m_slots.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+private:
+    size_t increment(size_t index) const
+    {
+        return index + 1 == m_slots.size() ? 0 : index + 1;
+    }
+
+    // 空出一个槽位区分满和空
+    std::vector<T> m_slots;
+    // 生产者和消费者各自写的索引相隔一个缓存行，避免伪共享。
+    // 不用 alignas：C++11 的 new 不保证扩展对齐
+    std::atomic<size_t> m_head;
+    char m_padding[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> m_tail;
+};
+
+#endif // SPSCQUEUE_H
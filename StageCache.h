@@ -0,0 +1,123 @@
+#ifndef STAGECACHE_H
+#define STAGECACHE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// 处理阶段的缓存键：对上一阶段的键和本阶段参数做 FNV-1a 散列
+class StageKey
+{
+public:
+    explicit StageKey(uint64_t seed = 14695981039346656037ull) : m_hash(seed) {}
+
+    template <typename T>
+    StageKey &add(const T &value)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (unsigned char b : bytes)
+        {
+            m_hash ^= b;
+            m_hash *= 1099511628211ull;
+        }
+        return *this;
+    }
+
+    uint64_t value() const { return m_hash; }
+
+private:
+    uint64_t m_hash;
+};
+
+// 小容量 LRU 缓存，保存某个阶段最近几组参数下的输出。
+// 条目按最近使用顺序存放在预留好容量的数组中，容量只有几项，线性查找比散列更快；
+// 缓存满后新条目覆盖最久未用的一项，插入和淘汰都不再分配内存（视频流每帧都是新键）。
+// find/insert 返回的指针和引用在下一次 find、insert 或 clear 之前有效
+template <typename T>
+class StageCache
+{
+public:
+    explicit StageCache(size_t capacity = 8) : m_capacity(capacity ? capacity : 1)
+    {
+        m_entries.reserve(m_capacity);
+    }
+
+    // 命中时返回缓存值并将其移到最近使用位置，未命中返回 nullptr
+    const T *find(uint64_t key)
+    {
+        auto it = lookup(key);
+        if (it == m_entries.end())
+        {
+            ++m_misses;
+            return nullptr;
+        }
+        ++m_hits;
+        return &moveToFront(it)->second;
+    }
+
+    const T &insert(uint64_t key, T value)
+    {
+        auto it = lookup(key);
+        if (it == m_entries.end())
+        {
+            if (m_entries.size() < m_capacity)
+            {
+                m_entries.emplace_back(key, T());
+                it = m_entries.end() - 1;
+            }
+            else
+            {
+                // 最后一项最久未用，原地覆盖
+                it = m_entries.end() - 1;
+                it->first = key;
+            }
+        }
+        it->second = std::move(value);
+        return moveToFront(it)->second;
+    }
+
+    void clear()
+    {
+        m_entries.clear();
+    }
+
+    // 按最近使用顺序遍历缓存值，不影响 LRU 顺序和命中统计
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (const auto &entry : m_entries)
+        {
+            f(entry.second);
+        }
+    }
+
+    size_t size() const { return m_entries.size(); }
+    size_t capacity() const { return m_capacity; }
+    uint64_t hits() const { return m_hits; }
+    uint64_t misses() const { return m_misses; }
+
+private:
+    typedef std::vector<std::pair<uint64_t, T>> EntryList;
+
+    typename EntryList::iterator lookup(uint64_t key)
+    {
+        return std::find_if(m_entries.begin(), m_entries.end(),
+                            [key](const std::pair<uint64_t, T> &entry) { return entry.first == key; });
+    }
+
+    typename EntryList::iterator moveToFront(typename EntryList::iterator it)
+    {
+        std::rotate(m_entries.begin(), it, it + 1);
+        return m_entries.begin();
+    }
+
+    size_t m_capacity;
+    EntryList m_entries;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+#endif // STAGECACHE_H
@@ -0,0 +1,293 @@
+#include "StageExecutor.h"
+#include <chrono>
+#include <thread>
+
+namespace
+{
+// 等待时先让出时间片，多次仍不成功再短暂休眠，避免空转占满一个核
+void backoff(int &attempt)
+{
+    if (attempt < 16)
+    {
+        ++attempt;
+        std::this_thread::yield();
+    }
+    else
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+}
+
+StageExecutor::StageExecutor(size_t queueCapacity)
+    : m_latestOnly(false)
+    , m_stopping(false)
+    , m_dropped(0)
+{
+    for (int i = 0; i < StageCount - 1; ++i)
+    {
+        m_queues[i].reset(new SpscQueue<Item>(queueCapacity));
+        m_maxDepth[i] = 0;
+    }
+    for (int i = 0; i < StageCount; ++i)
+    {
+        StageCounters &c = m_counters[i];
+        c.processed = 0;
+        c.stalls = 0;
+        c.stallNs = 0;
+        c.idleNs = 0;
+        c.busyNs = 0;
+        m_finished[i] = false;
+    }
+}
+
+int64_t StageExecutor::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char *StageExecutor::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case DecodeStage: return "decode";
+    case BlurStage: return "warp+gray+blur";
+    case EdgesStage: return "edges";
+    case ResultStage: return "circle+pointer+reading";
+    default: return "unknown";
+    }
+}
+
+StageExecutor::StageStats StageExecutor::stageStats(Stage stage) const
+{
+    StageStats stats;
+    if (stage < 0 || stage >= StageCount)
+    {
+        return stats;
+    }
+    const StageCounters &c = m_counters[stage];
+    stats.processed = c.processed.load();
+    stats.stalls = c.stalls.load();
+    stats.stallNs = c.stallNs.load();
+    stats.idleNs = c.idleNs.load();
+    stats.busyNs = c.busyNs.load();
+    return stats;
+}
+
+StageExecutor::QueueStats StageExecutor::queueStats(int queue) const
+{
+    QueueStats stats;
+    if (queue < 0 || queue >= StageCount - 1)
+    {
+        return stats;
+    }
+    stats.capacity = m_queues[queue]->capacity();
+    stats.depth = m_queues[queue]->size();
+    stats.maxDepth = m_maxDepth[queue].load();
+    return stats;
+}
+
+
+// --------------------阶段间传递--------------------
+bool StageExecutor::pop(Stage stage, Item &item)
+{
+    SpscQueue<Item> &queue = *m_queues[stage - 1];
+    const int64_t start = nowNs();
+    int attempt = 0;
+    bool ok = false;
+    while (!m_stopping)
+    {
+        if (queue.tryPop(item))
+        {
+            ok = true;
+            break;
+        }
+        // 先读结束标志再检查一次队列，保证上游最后放入的帧不会漏掉
+        if (m_finished[stage - 1].load())
+        {
+            ok = queue.tryPop(item);
+            break;
+        }
+        backoff(attempt);
+    }
+    m_counters[stage].idleNs += uint64_t(nowNs() - start);
+
+    // 只处理最新一帧时，把已经排队的旧帧丢掉
+    if (ok && m_latestOnly && stage == BlurStage)
+    {
+        Item newer;
+        while (queue.tryPop(newer))
+        {
+            item = std::move(newer);
+            ++m_dropped;
+        }
+    }
+    return ok;
+}
+
+bool StageExecutor::push(Stage stage, Item &item)
+{
+    SpscQueue<Item> &queue = *m_queues[stage];
+    if (!queue.tryPush(item))
+    {
+        ++m_counters[stage].stalls;
+        const int64_t start = nowNs();
+        int attempt = 0;
+        bool ok = false;
+        while (!m_stopping)
+        {
+            backoff(attempt);
+            if (queue.tryPush(item))
+            {
+                ok = true;
+                break;
+            }
+        }
+        m_counters[stage].stallNs += uint64_t(nowNs() - start);
+        if (!ok)
+        {
+            return false;
+        }
+    }
+
+    // 只有本阶段写这个最大值，无需比较交换
+    const size_t depth = queue.size();
+    if (depth > m_maxDepth[stage].load(std::memory_order_relaxed))
+    {
+        m_maxDepth[stage].store(depth, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void StageExecutor::stageLoop(Stage stage, const std::function<bool(Item &item)> &work)
+{
+    StageCounters &c = m_counters[stage];
+    while (!m_stopping)
+    {
+        Item item;
+        if (stage != DecodeStage && !pop(stage, item))
+        {
+            break;
+        }
+
+        if (stage == DecodeStage)
+        {
+            item.timings.begin("stream");
+        }
+        const int64_t start = nowNs();
+        bool more;
+        if (stage == ResultStage)
+        {
+            // 结果阶段在调用 sink 之前自己结束计时
+            more = work(item);
+        }
+        else
+        {
+            ScopedTimer timer(stageName(stage), &item.timings);
+            more = work(item);
+        }
+        c.busyNs += uint64_t(nowNs() - start);
+        if (!more)
+        {
+            break;
+        }
+        ++c.processed;
+
+        if (stage != ResultStage && !push(stage, item))
+        {
+            break;
+        }
+    }
+    m_finished[stage] = true;
+}
+
+
+// --------------------运行--------------------
+uint64_t StageExecutor::run(const Source &source, const Sink &sink)
+{
+    // 清空上一次运行残留的帧和统计
+    for (int i = 0; i < StageCount - 1; ++i)
+    {
+        Item item;
+        while (m_queues[i]->tryPop(item))
+        {
+        }
+        m_maxDepth[i] = 0;
+    }
+    for (int i = 0; i < StageCount; ++i)
+    {
+        StageCounters &c = m_counters[i];
+        c.processed = 0;
+        c.stalls = 0;
+        c.stallNs = 0;
+        c.idleNs = 0;
+        c.busyNs = 0;
+        m_finished[i] = false;
+    }
+    m_stopping = false;
+    m_dropped = 0;
+
+    // 各阶段只读参数快照；有状态的几何锁定和指针跟踪只在结果阶段使用
+    const GaugeParams params = m_params;
+
+    // 模糊和边缘阶段的输出写入本阶段池中的缓冲区，帧在结果阶段处理完、sink 返回后缓冲区回到池中
+    const cv::Size outputSize(params.outputWidth, params.outputHeight);
+    // 在途帧数由队列容量限定，启动线程前把对应数量的缓冲区分配好，运行中各阶段只取不分配：
+    // 模糊图存在于模糊、边缘、结果 3 个阶段和它们之间的 2 个队列中，
+    // 边缘图和 3 块梯度存在于边缘、结果 2 个阶段和它们之间的 1 个队列中
+    const size_t queueCapacity = m_queues[0]->capacity();
+    const size_t blurredInFlight = 2 * queueCapacity + 3;
+    const size_t edgesInFlight = queueCapacity + 2;
+    m_pools[BlurStage].reserve(outputSize, CV_8UC1, blurredInFlight);
+    m_pools[EdgesStage].reserve(outputSize, CV_8UC1, edgesInFlight);
+    m_pools[EdgesStage].reserve(outputSize, CV_16SC1, 3 * edgesInFlight);
+
+    std::thread threads[StageCount];
+    threads[DecodeStage] = std::thread([&]() {
+        stageLoop(DecodeStage, [&](Item &item) {
+            if (!source(item) || item.image.empty())
+            {
+                return false;
+            }
+            item.capturedNs = nowNs();
+            return true;
+        });
+    });
+    threads[BlurStage] = std::thread([&]() {
+        stageLoop(BlurStage, [&](Item &item) {
+            item.blurred = m_pools[BlurStage].acquire(outputSize, CV_8UC1);
+            GaugeCore::warpToBlurred(item.image, item.blurred, params);
+            return true;
+        });
+    });
+    threads[EdgesStage] = std::thread([&]() {
+        stageLoop(EdgesStage, [&](Item &item) {
+            GaugeCore::acquireEdgeBuffers(m_pools[EdgesStage], outputSize, item.edges, item.gradients);
+            GaugeCore::detectEdges(item.blurred, item.edges, params, &item.gradients);
+            return true;
+        });
+    });
+    threads[ResultStage] = std::thread([&]() {
+        stageLoop(ResultStage, [&](Item &item) {
+            {
+                ScopedTimer timer(stageName(ResultStage), &item.timings);
+                m_geometryLock.detectCircles(item.blurred, item.edges, item.gradients, params, item.result);
+                m_needleTracker.detectLines(item.edges, item.gradients, params, item.result);
+                GaugeCore::analyzeGauge(params, item.result);
+            }
+            item.timings.end();
+            if (sink)
+            {
+                sink(item);
+            }
+            return true;
+        });
+    });
+
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    return m_counters[ResultStage].processed.load();
+}
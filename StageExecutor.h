@@ -0,0 +1,125 @@
+#ifndef STAGEEXECUTOR_H
+#define STAGEEXECUTOR_H
+
+#include "GaugeCore.h"
+#include "GeometryLock.h"
+#include "NeedleTracker.h"
+#include "SpscQueue.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// 流水线执行器：解码、透视变换+灰度+模糊、边缘检测、圆+指针+读数四个阶段各占一个线程，
+// 阶段之间用有界无锁 SPSC 队列连接，下游处理不过来时上游等待（背压）。
+// 单路视频流的吞吐由最慢的阶段决定，而不是各阶段耗时之和；单帧延迟不变
+class StageExecutor
+{
+public:
+    enum Stage
+    {
+        DecodeStage,
+        BlurStage,
+        EdgesStage,
+        ResultStage,
+        StageCount
+    };
+
+    // 在阶段之间传递的一帧
+    struct Item
+    {
+        int64_t index = 0;
+        double timestampMs = 0.0;
+        int64_t capturedNs = 0;     // 解码完成的时间（StageExecutor::nowNs）
+        cv::Mat image;
+        cv::Mat blurred;
+        cv::Mat edges;
+        EdgeGradients gradients;
+        GaugeResult result;
+        StageTimings timings;       // StageTrace 打开时记录各阶段耗时，sink 收到时已完整
+    };
+
+    // 解码阶段：填写 image、index、timestampMs，返回 false 表示源结束
+    typedef std::function<bool(Item &item)> Source;
+    // 结果阶段算出读数后在同一线程调用
+    typedef std::function<void(const Item &item)> Sink;
+
+    struct StageStats
+    {
+        uint64_t processed = 0;
+        uint64_t stalls = 0;        // 下游队列满、需要等待的次数
+        uint64_t stallNs = 0;       // 等待下游的总时间
+        uint64_t idleNs = 0;        // 等待上游的总时间
+        uint64_t busyNs = 0;        // 处理本阶段的总时间
+    };
+
+    // 第 i 个队列连接第 i 和第 i + 1 个阶段
+    struct QueueStats
+    {
+        size_t capacity = 0;
+        size_t depth = 0;           // 当前深度
+        size_t maxDepth = 0;        // 运行中达到的最大深度
+    };
+
+    explicit StageExecutor(size_t queueCapacity = 4);
+
+    void setParameters(const GaugeParams &params) { m_params = params; }
+    const GaugeParams &parameters() const { return m_params; }
+
+    // 只处理最新一帧：模糊阶段取帧时把队列中更旧的帧丢弃
+    void setLatestOnly(bool enabled) { m_latestOnly = enabled; }
+    bool isLatestOnly() const { return m_latestOnly; }
+
+    // 结果阶段的状态，只在该阶段线程中使用，run 期间不得修改
+    GeometryLock &geometryLock() { return m_geometryLock; }
+    NeedleTracker &needleTracker() { return m_needleTracker; }
+
+    // 阻塞运行，直到源结束并且所有帧处理完，或者调用 stop()。返回送到 sink 的帧数
+    uint64_t run(const Source &source, const Sink &sink);
+    // 可在任意线程（包括 source/sink 中）调用，已在队列中的帧被丢弃
+    void stop() { m_stopping = true; }
+
+    // 运行中也可以读取
+    StageStats stageStats(Stage stage) const;
+    QueueStats queueStats(int queue) const;
+    uint64_t droppedCount() const { return m_dropped.load(); }
+
+    // 模糊和边缘阶段各自的输出缓冲区池，帧处理完释放后回到池中；run 结束后读取
+    const FramePool &pool(Stage stage) const { return m_pools[stage]; }
+
+    static const char *stageName(Stage stage);
+    // 单调时钟（纳秒），与 Item::capturedNs 同源
+    static int64_t nowNs();
+
+private:
+    struct StageCounters
+    {
+        std::atomic<uint64_t> processed;
+        std::atomic<uint64_t> stalls;
+        std::atomic<uint64_t> stallNs;
+        std::atomic<uint64_t> idleNs;
+        std::atomic<uint64_t> busyNs;
+    };
+
+    void stageLoop(Stage stage, const std::function<bool(Item &item)> &work);
+    // 从上游队列取一帧；上游已结束且队列为空，或正在停止时返回 false
+    bool pop(Stage stage, Item &item);
+    // 放入下游队列，队列满时等待；正在停止时返回 false
+    bool push(Stage stage, Item &item);
+
+    GaugeParams m_params;
+    bool m_latestOnly;
+    GeometryLock m_geometryLock;
+    NeedleTracker m_needleTracker;
+
+    std::unique_ptr<SpscQueue<Item>> m_queues[StageCount - 1];
+    std::atomic<size_t> m_maxDepth[StageCount - 1];
+    StageCounters m_counters[StageCount];
+    std::atomic<bool> m_finished[StageCount];
+    std::atomic<bool> m_stopping;
+    std::atomic<uint64_t> m_dropped;
+    // 每个阶段线程一个，只在该线程中取缓冲区
+    FramePool m_pools[StageCount];
+};
+
+#endif // STAGEEXECUTOR_H
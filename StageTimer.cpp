@@ -0,0 +1,196 @@
+#include "StageTimer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+namespace
+{
+struct TraceEvent
+{
+    const char *name;
+    int64_t startNs;
+    int64_t durationNs;
+    int threadId;
+    bool cached;
+};
+
+std::mutex g_mutex;
+std::vector<TraceEvent> g_events;
+size_t g_maxEvents = 0;
+std::atomic<bool> g_recording(false);
+std::atomic<int> g_nextThreadId(1);
+
+// trace 中的线程编号：按首次记录的顺序从 1 开始
+int currentThreadId()
+{
+    thread_local int id = 0;
+    if (id == 0)
+    {
+        id = g_nextThreadId++;
+    }
+    return id;
+}
+}
+
+namespace StageTrace
+{
+namespace detail
+{
+std::atomic<bool> enabled(false);
+}
+
+void setEnabled(bool enabled)
+{
+    detail::enabled = enabled;
+}
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void startRecording(size_t maxEvents)
+{
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_events.clear();
+    g_maxEvents = maxEvents;
+    g_recording = true;
+    detail::enabled = true;
+}
+
+void stopRecording()
+{
+    g_recording = false;
+}
+
+bool isRecording()
+{
+    return g_recording.load(std::memory_order_relaxed);
+}
+
+void record(const char *name, int64_t startNs, int64_t endNs, bool cached)
+{
+    if (!isRecording())
+    {
+        return;
+    }
+    const int threadId = currentThreadId();
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (g_events.size() < g_maxEvents)
+    {
+        g_events.push_back({ name, startNs, endNs - startNs, threadId, cached });
+    }
+}
+
+bool writeChromeTrace(const std::string &fileName)
+{
+    std::vector<TraceEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        events = g_events;
+    }
+
+    FILE *file = std::fopen(fileName.c_str(), "w");
+    if (!file)
+    {
+        return false;
+    }
+
+    // 时间戳以最早开始的事件为 0 点，单位微秒。事件按结束顺序记录，最早开始的不一定是第一条
+    int64_t originNs = events.empty() ? 0 : events.front().startNs;
+    for (const auto &e : events)
+    {
+        originNs = std::min(originNs, e.startNs);
+    }
+    std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const TraceEvent &e = events[i];
+        std::fprintf(file,
+                     "  {\"name\": \"%s\", \"cat\": \"gauge\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                     "\"pid\": 1, \"tid\": %d, \"args\": {\"cached\": %s}}%s\n",
+                     e.name, (e.startNs - originNs) / 1e3, e.durationNs / 1e3, e.threadId,
+                     e.cached ? "true" : "false", i + 1 < events.size() ? "," : "");
+    }
+    std::fprintf(file, "]}\n");
+    std::fclose(file);
+    return true;
+}
+}
+
+
+// --------------------StageTimings--------------------
+void StageTimings::begin(const char *triggerName)
+{
+    stages.clear();
+    trigger = triggerName;
+    totalMs = 0.0;
+    originNs = StageTrace::isEnabled() ? StageTrace::nowNs() : 0;
+}
+
+void StageTimings::end()
+{
+    if (originNs != 0)
+    {
+        totalMs = (StageTrace::nowNs() - originNs) / 1e6;
+    }
+}
+
+void StageTimings::markCached(const char *name)
+{
+    if (originNs == 0)
+    {
+        return;
+    }
+    StageTiming timing;
+    timing.name = name;
+    timing.startMs = (StageTrace::nowNs() - originNs) / 1e6;
+    timing.cached = true;
+    stages.push_back(timing);
+}
+
+double StageTimings::stageMs(const char *name) const
+{
+    double total = 0.0;
+    for (const auto &stage : stages)
+    {
+        if (std::strcmp(stage.name, name) == 0)
+        {
+            total += stage.durationMs;
+        }
+    }
+    return total;
+}
+
+
+// --------------------ScopedTimer--------------------
+ScopedTimer::ScopedTimer(const char *name, StageTimings *timings)
+    : m_name(name)
+    , m_timings(timings)
+    , m_startNs(StageTrace::isEnabled() ? StageTrace::nowNs() : 0)
+{
+}
+
+void ScopedTimer::stop()
+{
+    if (m_startNs == 0)
+    {
+        return;
+    }
+    const int64_t endNs = StageTrace::nowNs();
+    if (m_timings)
+    {
+        StageTiming timing;
+        timing.name = m_name;
+        // timings 未 begin 时以本阶段开始为 0 点
+        const int64_t originNs = m_timings->originNs != 0 ? m_timings->originNs : m_startNs;
+        timing.startMs = (m_startNs - originNs) / 1e6;
+        timing.durationMs = (endNs - m_startNs) / 1e6;
+        m_timings->stages.push_back(timing);
+    }
+    StageTrace::record(m_name, m_startNs, endNs, false);
+    m_startNs = 0;
+}
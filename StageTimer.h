@@ -0,0 +1,77 @@
+#ifndef STAGETIMER_H
+#define STAGETIMER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 一个阶段的耗时
+struct StageTiming
+{
+    const char *name = "";      // 静态字符串
+    double startMs = 0.0;       // 相对本次处理开始的时间
+    double durationMs = 0.0;
+    bool cached = false;        // 命中缓存，没有重新计算
+};
+
+// 一次处理中各阶段的耗时，随结果一起返回。计时关闭时为空
+struct StageTimings
+{
+    std::vector<StageTiming> stages;
+    const char *trigger = "";   // 触发本次处理的操作，例如 setCannyThresholds
+    int64_t originNs = 0;       // 本次处理开始的时间（StageTrace::nowNs），0 表示未计时
+    double totalMs = 0.0;
+
+    bool empty() const { return stages.empty(); }
+    // 计时打开时清空并记下开始时间；关闭时只清空
+    void begin(const char *triggerName = "");
+    void end();
+    // 命中缓存的阶段记一条耗时为 0 的记录
+    void markCached(const char *name);
+    double stageMs(const char *name) const;
+};
+
+// 计时开关和 Chrome trace 记录。关闭时 ScopedTimer 的开销只有一次原子读
+namespace StageTrace
+{
+namespace detail
+{
+extern std::atomic<bool> enabled;
+}
+
+inline bool isEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+
+// 单调时钟（纳秒）
+int64_t nowNs();
+
+// 开始记录计时事件（同时打开计时），writeChromeTrace 写出 trace event 格式的 JSON，
+// 可在 chrome://tracing 或 ui.perfetto.dev 中打开。事件数超过上限后不再记录
+void startRecording(size_t maxEvents = 1000000);
+void stopRecording();
+bool isRecording();
+bool writeChromeTrace(const std::string &fileName);
+
+void record(const char *name, int64_t startNs, int64_t endNs, bool cached);
+}
+
+// 作用域计时：构造时开始，析构或 stop() 时结束，写入 timings（可为空）并在记录中时加入 trace
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(const char *name, StageTimings *timings = nullptr);
+    ~ScopedTimer() { stop(); }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    void stop();
+
+private:
+    const char *m_name;
+    StageTimings *m_timings;
+    int64_t m_startNs;          // 0 表示未计时或已结束
+};
+
+#endif // STAGETIMER_H
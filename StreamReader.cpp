@@ -0,0 +1,475 @@
+#include "StreamReader.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <chrono>
+#include <thread>
+
+StreamReader::StreamReader()
+    : m_live(false)
+    , m_policy(LatestOnly)
+    , m_targetFps(0.0)
+    , m_realTime(false)
+    , m_maxFrames(0)
+    , m_pipelined(false)
+    , m_sourceId(0)
+    , m_frameType(0)
+    , m_captureDone(false)
+    , m_stopping(false)
+    , m_captured(0)
+    , m_processed(0)
+    , m_dropped(0)
+{
+    // 只要读数，不生成彩色透视图，中间图像每帧都变、缓存不会命中，算到复用的临时缓冲区；
+    // 固定机位的流默认锁定表盘并跟踪指针
+    m_pipeline.setColorWarpEnabled(false);
+    m_pipeline.setRetainedOutputs(GaugePipeline::NoOutputs);
+    m_pipeline.setGeometryLockEnabled(true);
+    m_pipeline.setNeedleTrackingEnabled(true);
+}
+
+StreamReader::~StreamReader()
+{
+    close();
+}
+
+bool StreamReader::open(const QString &source)
+{
+    close();
+
+#ifdef Q_OS_LINUX
+    const int deviceApi = cv::CAP_V4L2;
+#else
+    const int deviceApi = cv::CAP_ANY;
+#endif
+
+    bool isIndex = false;
+    const int index = source.toInt(&isIndex);
+    if (isIndex)
+    {
+        m_live = true;
+        if (!m_capture.open(index, deviceApi))
+        {
+            m_capture.open(index, cv::CAP_ANY);
+        }
+    }
+    else if (source.startsWith("/dev/video"))
+    {
+        m_live = true;
+        if (!m_capture.open(source.toStdString(), deviceApi))
+        {
+            m_capture.open(source.toStdString(), cv::CAP_ANY);
+        }
+    }
+    else
+    {
+        m_live = false;
+        m_capture.open(source.toStdString());
+    }
+    return isOpen();
+}
+
+void StreamReader::close()
+{
+    m_capture.release();
+    m_live = false;
+}
+
+double StreamReader::sourceFps() const
+{
+    const double fps = m_capture.get(cv::CAP_PROP_FPS);
+    return fps > 0 && fps < 1000 ? fps : 0.0;
+}
+
+bool StreamReader::parsePolicy(const QString &name, Policy &policy)
+{
+    if (name == "every")
+    {
+        policy = EveryFrame;
+    }
+    else if (name == "latest")
+    {
+        policy = LatestOnly;
+    }
+    else if (name == "rate")
+    {
+        policy = FixedRate;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+
+// --------------------采集线程--------------------
+void StreamReader::push(Frame frame)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_policy == EveryFrame)
+    {
+        m_condition.wait(lock, [this]() { return m_queue.size() < QueueCapacity || m_stopping; });
+        if (m_stopping)
+        {
+            return;
+        }
+    }
+    else
+    {
+        // 只保留最新一帧
+        m_dropped += qint64(m_queue.size());
+        m_queue.clear();
+    }
+    m_queue.push_back(std::move(frame));
+    lock.unlock();
+    m_condition.notify_all();
+}
+
+bool StreamReader::readFrame(Frame &frame, double &nextDueMs)
+{
+    const double periodMs = m_targetFps > 0 ? 1000.0 / m_targetFps : 0.0;
+    while (!m_stopping)
+    {
+        // 尺寸不变时解码直接写入池中的空闲缓冲区；固定帧率跳过的帧复用同一块
+        if (frame.image.empty() && !m_frameSize.empty())
+        {
+            frame.image = m_capturePool.acquire(m_frameSize, m_frameType);
+        }
+        if (!m_capture.read(frame.image) || frame.image.empty())
+        {
+            return false;
+        }
+        m_frameSize = frame.image.size();
+        m_frameType = frame.image.type();
+        frame.index = m_captured++;
+        frame.capturedNs = m_clock.nsecsElapsed();
+        frame.timestampMs = m_live ? frame.capturedNs / 1e6 : m_capture.get(cv::CAP_PROP_POS_MSEC);
+
+        // 文件按自身时间戳放出，模拟实时摄像头
+        if (!m_live && m_realTime)
+        {
+            const double waitMs = frame.timestampMs - m_clock.nsecsElapsed() / 1e6;
+            if (waitMs > 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(qint64(waitMs * 1000)));
+            }
+            frame.capturedNs = m_clock.nsecsElapsed();
+        }
+
+        // 固定帧率：按时间戳取帧，与处理速度无关，同一文件每次取到的帧相同。nextDueMs 小于 0 表示第一帧
+        if (m_policy == FixedRate && periodMs > 0)
+        {
+            if (nextDueMs >= 0 && frame.timestampMs < nextDueMs)
+            {
+                ++m_dropped;
+                continue;
+            }
+            // 落后超过一个周期时从当前帧重新对齐，不补帧
+            nextDueMs = nextDueMs < 0 || frame.timestampMs - nextDueMs >= periodMs
+                    ? frame.timestampMs + periodMs : nextDueMs + periodMs;
+        }
+        return true;
+    }
+    return false;
+}
+
+void StreamReader::captureLoop()
+{
+    double nextDueMs = -1.0;
+    Frame frame;
+    while (readFrame(frame, nextDueMs))
+    {
+        push(std::move(frame));
+        frame = Frame();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_captureDone = true;
+    }
+    m_condition.notify_all();
+}
+
+
+// --------------------处理线程--------------------
+qint64 StreamReader::run(const Callback &callback)
+{
+    if (!isOpen())
+    {
+        return 0;
+    }
+
+    m_queue.clear();
+    m_captureDone = false;
+    m_stopping = false;
+    m_captured = 0;
+    m_processed = 0;
+    m_dropped = 0;
+
+    // 设备自带的缓冲会让“最新帧”变成几帧之前的画面
+    if (m_live && m_policy != EveryFrame)
+    {
+        m_capture.set(cv::CAP_PROP_BUFFERSIZE, 1);
+    }
+
+    m_clock.start();
+    if (m_pipelined)
+    {
+        return runPipelined(callback);
+    }
+    std::thread capture(&StreamReader::captureLoop, this);
+
+    while (true)
+    {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return !m_queue.empty() || m_captureDone || m_stopping; });
+            if (m_stopping || m_queue.empty())
+            {
+                break;
+            }
+            frame = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_condition.notify_all();
+
+        m_pipeline.setSource(frame.image, ++m_sourceId);
+        GaugeFrame gaugeFrame;
+        const GaugeResult result = m_pipeline.run(m_params, gaugeFrame);
+
+        StreamReading reading;
+        reading.frameIndex = frame.index;
+        reading.timestampMs = frame.timestampMs;
+        reading.ok = result.isValid();
+        reading.reading = result.reading;
+        reading.angle = result.angle;
+        reading.confidence = result.confidence;
+        reading.latencyMs = (m_clock.nsecsElapsed() - frame.capturedNs) / 1e6;
+        reading.timings = gaugeFrame.timings;
+        reading.timings.trigger = "stream";
+        ++m_processed;
+
+        if (callback)
+        {
+            callback(reading);
+        }
+        if (m_maxFrames > 0 && m_processed >= m_maxFrames)
+        {
+            break;
+        }
+    }
+
+    stop();
+    capture.join();
+    m_pipeline.setSource(cv::Mat(), ++m_sourceId);
+    return m_processed;
+}
+
+qint64 StreamReader::runPipelined(const Callback &callback)
+{
+    // 解码在执行器的解码线程中进行；只取最新帧时由模糊阶段丢弃排队的旧帧
+    m_executor.setParameters(m_params);
+    m_executor.setLatestOnly(m_policy == LatestOnly);
+    m_executor.geometryLock().setEnabled(m_pipeline.isGeometryLockEnabled());
+    m_executor.needleTracker().setEnabled(m_pipeline.isNeedleTrackingEnabled());
+
+    double nextDueMs = -1.0;
+    m_executor.run([&](StageExecutor::Item &item) {
+        Frame frame;
+        if (!readFrame(frame, nextDueMs))
+        {
+            return false;
+        }
+        item.image = frame.image;
+        item.index = frame.index;
+        item.timestampMs = frame.timestampMs;
+        return true;
+    }, [&](const StageExecutor::Item &item) {
+        StreamReading reading;
+        reading.frameIndex = item.index;
+        reading.timestampMs = item.timestampMs;
+        reading.ok = item.result.isValid();
+        reading.reading = item.result.reading;
+        reading.angle = item.result.angle;
+        reading.confidence = item.result.confidence;
+        reading.latencyMs = (StageExecutor::nowNs() - item.capturedNs) / 1e6;
+        reading.timings = item.timings;
+        ++m_processed;
+
+        if (callback)
+        {
+            callback(reading);
+        }
+        if (m_stopping || (m_maxFrames > 0 && m_processed >= m_maxFrames))
+        {
+            m_executor.stop();
+        }
+    });
+
+    m_dropped += qint64(m_executor.droppedCount());
+    return m_processed;
+}
+
+void StreamReader::setProfile(const GaugeProfile &profile)
+{
+    m_params = profile.params;
+    profile.warmUp(&m_pipeline.geometryLock());
+    profile.warmUp(&m_executor.geometryLock());
+}
+
+void StreamReader::stop()
+{
+    // 持锁修改，避免等待方在检查条件和进入等待之间错过通知
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    m_executor.stop();
+}
+
+
+// --------------------命令行入口--------------------
+int StreamReader::runCommandLine(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("仪表识别视频流模式");
+    parser.addHelpOption();
+    parser.addOption({"stream", "视频文件、设备编号或 /dev/videoN", "source"});
+    parser.addOption({{"p", "policy"}, "取帧策略：every（每帧）、latest（只取最新，默认）、rate（固定帧率）", "policy", "latest"});
+    parser.addOption({"fps", "rate 策略的目标帧率", "n", "5"});
+    parser.addOption({"realtime", "视频文件按自身帧率读取，模拟摄像头"});
+    parser.addOption({{"n", "max-frames"}, "最多处理的帧数", "n"});
+    parser.addOption({"profile", "仪表配置文件（多块表时使用第一块）", "file"});
+    parser.addOption({"no-lock", "关闭表盘几何锁定"});
+    parser.addOption({"no-track", "关闭指针跟踪"});
+    parser.addOption({"pipelined", "四个阶段各用一个线程流水处理"});
+    parser.addOption({{"o", "output"}, "结果 CSV 文件（默认输出到标准输出）", "file"});
+    parser.addOption({"trace", "各阶段计时写为 Chrome trace JSON（chrome://tracing 或 Perfetto 打开）", "file"});
+    parser.process(app);
+
+    if (parser.isSet("trace"))
+    {
+        StageTrace::startRecording();
+    }
+
+    StreamReader reader;
+    Policy policy;
+    if (!parsePolicy(parser.value("policy"), policy))
+    {
+        qCritical() << "未知的取帧策略:" << parser.value("policy");
+        return 1;
+    }
+    reader.setPolicy(policy);
+    reader.setTargetRate(parser.value("fps").toDouble());
+    reader.setRealTime(parser.isSet("realtime"));
+    if (parser.isSet("max-frames"))
+    {
+        reader.setMaxFrames(parser.value("max-frames").toLongLong());
+    }
+    if (parser.isSet("profile"))
+    {
+        std::vector<GaugeProfile> profiles;
+        QString error;
+        if (!GaugeProfile::load(parser.value("profile"), profiles, &error))
+        {
+            qCritical() << error;
+            return 1;
+        }
+        reader.setProfile(profiles.front());
+    }
+    // 关闭锁定会同时清除配置文件中的表盘圆
+    reader.pipeline().setGeometryLockEnabled(!parser.isSet("no-lock"));
+    reader.pipeline().setNeedleTrackingEnabled(!parser.isSet("no-track"));
+    reader.setPipelined(parser.isSet("pipelined"));
+
+    if (!reader.open(parser.value("stream")))
+    {
+        qCritical() << "无法打开视频源:" << parser.value("stream");
+        return 1;
+    }
+
+    QFile file;
+    QTextStream out(stdout);
+    if (parser.isSet("output"))
+    {
+        file.setFileName(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+        {
+            qCritical() << "无法写入结果文件:" << parser.value("output");
+            return 1;
+        }
+        out.setDevice(&file);
+        out << "frame,timestamp_ms,ok,reading,angle,confidence,latency_ms\n";
+    }
+
+    const bool csv = parser.isSet("output");
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 processed = reader.run([&](const StreamReading &r) {
+        if (csv)
+        {
+            out << r.frameIndex << ','
+                << QString::number(r.timestampMs, 'f', 1) << ','
+                << (r.ok ? 1 : 0) << ','
+                << (r.ok ? QString::number(r.reading, 'f', 4) : QString()) << ','
+                << (r.ok ? QString::number(r.angle, 'f', 3) : QString()) << ','
+                << QString::number(r.confidence, 'f', 3) << ','
+                << QString::number(r.latencyMs, 'f', 2) << '\n';
+        }
+        else
+        {
+            out << r.frameIndex << '\t'
+                << QString::number(r.timestampMs, 'f', 1) << '\t'
+                << (r.ok ? QString::number(r.reading, 'f', 4) : QString("NOT_FOUND")) << '\n';
+            out.flush();
+        }
+    });
+    out.flush();
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    QTextStream err(stderr);
+    err << QString("采集 %1 帧，处理 %2，丢弃 %3，耗时 %4 s，%5 帧/秒\n")
+           .arg(reader.capturedCount())
+           .arg(processed)
+           .arg(reader.droppedCount())
+           .arg(seconds, 0, 'f', 2)
+           .arg(seconds > 0 ? processed / seconds : 0.0, 0, 'f', 1);
+
+    // 流水线模式下输出各阶段的忙闲和队列情况，最忙的阶段就是吞吐瓶颈
+    if (reader.isPipelined())
+    {
+        const StageExecutor &executor = reader.executor();
+        for (int i = 0; i < StageExecutor::StageCount; ++i)
+        {
+            const StageExecutor::Stage stage = StageExecutor::Stage(i);
+            const StageExecutor::StageStats stats = executor.stageStats(stage);
+            err << QString("  %1: %2 帧，平均 %3 ms，等待上游 %4 ms，阻塞 %5 次 / %6 ms")
+                   .arg(StageExecutor::stageName(stage), -24)
+                   .arg(stats.processed)
+                   .arg(stats.processed ? stats.busyNs / 1e6 / stats.processed : 0.0, 0, 'f', 2)
+                   .arg(stats.idleNs / 1e6, 0, 'f', 1)
+                   .arg(stats.stalls)
+                   .arg(stats.stallNs / 1e6, 0, 'f', 1);
+            if (i < StageExecutor::StageCount - 1)
+            {
+                const StageExecutor::QueueStats queue = executor.queueStats(i);
+                err << QString("，队列最大深度 %1/%2").arg(queue.maxDepth).arg(queue.capacity);
+            }
+            err << '\n';
+        }
+    }
+
+    if (parser.isSet("trace") && !StageTrace::writeChromeTrace(parser.value("trace").toStdString()))
+    {
+        qCritical() << "无法写入 trace 文件:" << parser.value("trace");
+    }
+
+    return processed > 0 ? 0 : 2;
+}
@@ -0,0 +1,135 @@
+#ifndef STREAMREADER_H
+#define STREAMREADER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "GaugePipeline.h"
+#include "GaugeProfile.h"
+#include "StageExecutor.h"
+
+// 视频流中处理的一帧
+struct StreamReading
+{
+    qint64 frameIndex = 0;      // 源中的帧序号（从 0 开始），丢帧时不连续
+    double timestampMs = 0.0;   // 视频文件为帧在文件中的时间；设备为自开始采集起的时间
+    bool ok = false;            // 是否同时找到表盘和指针
+    double reading = 0.0;
+    double angle = 0.0;
+    double confidence = 0.0;
+    double latencyMs = 0.0;     // 从取到帧到得出读数的时间
+    StageTimings timings;       // 各阶段耗时（StageTrace 打开时）
+};
+
+// 视频流识别：采集线程用 cv::VideoCapture 读取视频文件或摄像头（Linux 下设备走 V4L2），
+// 处理线程用带几何锁定和指针跟踪的处理链逐帧识别，每处理一帧回调一次读数
+class StreamReader
+{
+public:
+    enum Policy
+    {
+        EveryFrame,     // 处理每一帧，处理不过来时采集线程等待（文件不丢帧）
+        LatestOnly,     // 只处理最新一帧，处理期间到达的旧帧丢弃
+        FixedRate       // 按帧时间戳以固定帧率取帧，其余丢弃
+    };
+
+    typedef std::function<void(const StreamReading &)> Callback;
+
+    StreamReader();
+    ~StreamReader();
+
+    // source 为视频文件路径，或设备编号（"0"）/设备文件（"/dev/video0"）
+    bool open(const QString &source);
+    void close();
+    bool isOpen() const { return m_capture.isOpened(); }
+    bool isLive() const { return m_live; }
+    // 源报告的帧率，未知时为 0
+    double sourceFps() const;
+
+    void setPolicy(Policy policy) { m_policy = policy; }
+    Policy policy() const { return m_policy; }
+    void setTargetRate(double fps) { m_targetFps = fps; }
+    double targetRate() const { return m_targetFps; }
+    // 按文件自身帧率读取，模拟实时摄像头（只对视频文件有效）
+    void setRealTime(bool enabled) { m_realTime = enabled; }
+    // 最多处理的帧数，0 为不限
+    void setMaxFrames(qint64 count) { m_maxFrames = count; }
+    // 流水线模式：解码、模糊、边缘、结果四个阶段各占一个线程（StageExecutor），
+    // 吞吐接近最慢阶段的速度。几何锁定和指针跟踪的开关沿用 pipeline() 的设置
+    void setPipelined(bool enabled) { m_pipelined = enabled; }
+    bool isPipelined() const { return m_pipelined; }
+    const StageExecutor &executor() const { return m_executor; }
+
+    void setParameters(const GaugeParams &params) { m_params = params; }
+    // 使用配置文件中的一块表：参数、映射表，以及顺序和流水两种模式下的几何锁定
+    void setProfile(const GaugeProfile &profile);
+    const GaugeParams &parameters() const { return m_params; }
+    GaugePipeline &pipeline() { return m_pipeline; }
+
+    // 阻塞运行，直到源结束、达到最大帧数或调用 stop()；callback 在处理线程中调用。返回处理的帧数
+    qint64 run(const Callback &callback);
+    // 可在任意线程（包括回调中）调用
+    void stop();
+
+    qint64 capturedCount() const { return m_captured; }
+    qint64 processedCount() const { return m_processed; }
+    qint64 droppedCount() const { return m_dropped; }
+
+    static bool parsePolicy(const QString &name, Policy &policy);
+
+    // 命令行入口：Instrument_identification --stream <源> [选项]
+    static int runCommandLine(int argc, char *argv[]);
+
+private:
+    struct Frame
+    {
+        cv::Mat image;
+        qint64 index = 0;
+        double timestampMs = 0.0;
+        qint64 capturedNs = 0;
+    };
+
+    // 读下一帧并按固定帧率策略筛选，源结束或正在停止时返回 false
+    bool readFrame(Frame &frame, double &nextDueMs);
+    void captureLoop();
+    qint64 runPipelined(const Callback &callback);
+    // 按策略把一帧交给处理线程，EveryFrame 时队列满则等待
+    void push(Frame frame);
+
+    cv::VideoCapture m_capture;
+    bool m_live;
+    Policy m_policy;
+    double m_targetFps;
+    bool m_realTime;
+    qint64 m_maxFrames;
+    bool m_pipelined;
+    GaugeParams m_params;
+    GaugePipeline m_pipeline;
+    StageExecutor m_executor;
+    uint64_t m_sourceId;            // 每帧递增，跨多次 run 也不重复
+    // 解码输出的缓冲区池，只在读帧的线程中使用；尺寸取上一帧的
+    FramePool m_capturePool;
+    cv::Size m_frameSize;
+    int m_frameType;
+    QElapsedTimer m_clock;          // run 开始时启动，两个线程共用
+
+    // 采集线程到处理线程的交接队列
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<Frame> m_queue;
+    bool m_captureDone;
+    std::atomic<bool> m_stopping;
+
+    std::atomic<qint64> m_captured;
+    std::atomic<qint64> m_processed;
+    std::atomic<qint64> m_dropped;
+
+    // EveryFrame 策略下的队列长度
+    static const size_t QueueCapacity = 4;
+};
+
+#endif // STREAMREADER_H
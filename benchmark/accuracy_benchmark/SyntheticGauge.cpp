@@ -0,0 +1,168 @@
+#include "SyntheticGauge.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+cv::Point2f polarPoint(const cv::Point2f &center, double radius, double degrees)
+{
+    const double a = degrees * CV_PI / 180.0;
+    // 图像 y 轴向下，角度按逆时针为正
+    return center + cv::Point2f(float(radius * std::cos(a)), float(-radius * std::sin(a)));
+}
+
+cv::Scalar gray(double level)
+{
+    return cv::Scalar(level, level, level);
+}
+}
+
+SyntheticGaugeGenerator::SyntheticGaugeGenerator(const SyntheticGaugeOptions &options)
+    : m_options(options)
+{
+}
+
+
+// --------------------正视表盘--------------------
+cv::Mat SyntheticGaugeGenerator::renderFace(cv::RNG &rng, SyntheticGauge &gauge) const
+{
+    const SyntheticGaugeOptions &o = m_options;
+    const double shortSide = std::min(o.outputSize.width, o.outputSize.height);
+
+    const double radius = shortSide * rng.uniform(o.minRadiusRatio, o.maxRadiusRatio);
+    // 圆心随机偏离中心，但表盘不超出画面
+    const double slackX = std::max(0.0, o.outputSize.width / 2.0 - radius - 4);
+    const double slackY = std::max(0.0, o.outputSize.height / 2.0 - radius - 4);
+    const cv::Point2f center(float(o.outputSize.width / 2.0 + rng.uniform(-slackX, slackX + 1e-6)),
+                             float(o.outputSize.height / 2.0 + rng.uniform(-slackY, slackY + 1e-6)));
+    gauge.circle = cv::Vec3f(center.x, center.y, float(radius));
+
+    const double t = rng.uniform(0.0, 1.0);
+    gauge.value = o.minValue + t * (o.maxValue - o.minValue);
+    gauge.needleAngle = o.startAngle - t * o.sweep;
+
+    cv::Mat face(o.outputSize, CV_8UC3, gray(rng.uniform(40, 100)));
+    const int faceLevel = rng.uniform(195, 245);
+    const int inkLevel = rng.uniform(15, 50);
+    const cv::Point c(cvRound(center.x), cvRound(center.y));
+    const int r = cvRound(radius);
+
+    cv::circle(face, c, r, gray(faceLevel), -1, cv::LINE_AA);
+    cv::circle(face, c, r, gray(inkLevel), std::max(3, cvRound(radius * 0.03)), cv::LINE_AA);
+
+    // 刻度：主刻度长而粗，副刻度短而细
+    const int ticks = (o.majorTicks - 1) * (o.minorPerMajor + 1);
+    for (int i = 0; i <= ticks; ++i)
+    {
+        const bool major = i % (o.minorPerMajor + 1) == 0;
+        const double a = o.startAngle - o.sweep * i / std::max(1, ticks);
+        cv::line(face, polarPoint(center, radius * (major ? 0.80 : 0.87), a),
+                 polarPoint(center, radius * 0.94, a),
+                 gray(inkLevel), major ? std::max(2, cvRound(radius * 0.012)) : 1, cv::LINE_AA);
+    }
+
+    // 指针：从尾部到针尖逐渐变细的多边形，圆心处有轴帽
+    const double tipLength = radius * rng.uniform(0.72, 0.82);
+    const double tailLength = radius * 0.15;
+    const double halfWidth = radius * 0.018;
+    const cv::Point2f tip = polarPoint(center, tipLength, gauge.needleAngle);
+    const cv::Point2f tail = polarPoint(center, tailLength, gauge.needleAngle + 180.0);
+    const cv::Point2f side = polarPoint(cv::Point2f(0, 0), halfWidth, gauge.needleAngle + 90.0);
+    std::vector<cv::Point> needle = {
+        cv::Point(cvRound(tip.x), cvRound(tip.y)),
+        cv::Point(cvRound(tail.x + side.x), cvRound(tail.y + side.y)),
+        cv::Point(cvRound(tail.x - side.x), cvRound(tail.y - side.y))
+    };
+    cv::fillConvexPoly(face, needle, gray(inkLevel), cv::LINE_AA);
+    cv::circle(face, c, std::max(3, cvRound(radius * 0.06)), gray(inkLevel), -1, cv::LINE_AA);
+    return face;
+}
+
+
+// --------------------透视、模糊、噪声、光照--------------------
+SyntheticGauge SyntheticGaugeGenerator::render(uint64_t seed, uint64_t index) const
+{
+    const SyntheticGaugeOptions &o = m_options;
+    cv::RNG rng(seed * 0x9E3779B97F4A7C15ull + index * 0xBF58476D1CE4E5B9ull + 1);
+
+    SyntheticGauge gauge;
+    const cv::Mat face = renderFace(rng, gauge);
+
+    // 表盘区域先居中缩放到原图内，再把四个角各自随机偏移
+    const double scale = std::min(o.imageSize.width * 0.85 / o.outputSize.width,
+                                  o.imageSize.height * 0.85 / o.outputSize.height);
+    const cv::Point2f offset(float((o.imageSize.width - o.outputSize.width * scale) / 2),
+                             float((o.imageSize.height - o.outputSize.height * scale) / 2));
+    const float w = float(o.outputSize.width);
+    const float h = float(o.outputSize.height);
+    const std::vector<cv::Point2f> faceCorners = { cv::Point2f(0, 0), cv::Point2f(w, 0),
+                                                   cv::Point2f(w, h), cv::Point2f(0, h) };
+    const double skew = o.maxSkew * std::min(o.imageSize.width, o.imageSize.height);
+    for (const auto &corner : faceCorners)
+    {
+        gauge.quad.push_back(offset + corner * float(scale)
+                             + cv::Point2f(float(rng.uniform(-skew, skew + 1e-6)),
+                                           float(rng.uniform(-skew, skew + 1e-6))));
+    }
+
+    const cv::Mat homography = cv::getPerspectiveTransform(faceCorners, gauge.quad);
+    cv::warpPerspective(face, gauge.image, homography, o.imageSize, cv::INTER_LINEAR,
+                        cv::BORDER_CONSTANT, gray(rng.uniform(30, 90)));
+
+    // 光照：沿随机方向线性变暗
+    const double lighting = rng.uniform(0.0, o.maxLighting + 1e-9);
+    if (lighting > 0.01)
+    {
+        const double direction = rng.uniform(0.0, 2 * CV_PI);
+        const double dx = std::cos(direction) / o.imageSize.width;
+        const double dy = std::sin(direction) / o.imageSize.height;
+        for (int y = 0; y < gauge.image.rows; ++y)
+        {
+            uchar *row = gauge.image.ptr<uchar>(y);
+            for (int x = 0; x < gauge.image.cols; ++x)
+            {
+                // proj 在 [-1, 1] 之间，增益在 [1 - lighting, 1] 之间
+                const double proj = 2 * ((x - gauge.image.cols / 2.0) * dx + (y - gauge.image.rows / 2.0) * dy);
+                const double gain = 1.0 - lighting * 0.5 * (1.0 + std::max(-1.0, std::min(1.0, proj)));
+                for (int ch = 0; ch < 3; ++ch)
+                {
+                    row[x * 3 + ch] = cv::saturate_cast<uchar>(row[x * 3 + ch] * gain);
+                }
+            }
+        }
+    }
+
+    const double sigma = rng.uniform(0.0, o.maxBlurSigma + 1e-9);
+    if (sigma > 0.1)
+    {
+        cv::GaussianBlur(gauge.image, gauge.image, cv::Size(0, 0), sigma);
+    }
+
+    // 噪声用有符号类型叠加，避免负值被截断成偏亮
+    const double noiseSigma = rng.uniform(0.0, o.maxNoiseSigma + 1e-9);
+    if (noiseSigma > 0.1)
+    {
+        cv::Mat noise(o.imageSize, CV_16SC3);
+        rng.fill(noise, cv::RNG::NORMAL, 0, noiseSigma);
+        cv::add(gauge.image, noise, gauge.image, cv::noArray(), CV_8UC3);
+    }
+    return gauge;
+}
+
+GaugeParams SyntheticGaugeGenerator::params(const SyntheticGauge &gauge) const
+{
+    const SyntheticGaugeOptions &o = m_options;
+    const double shortSide = std::min(o.outputSize.width, o.outputSize.height);
+
+    GaugeParams params;
+    params.sourcePoints = gauge.quad;
+    params.outputWidth = o.outputSize.width;
+    params.outputHeight = o.outputSize.height;
+    params.minRadius = int(std::floor(shortSide * o.minRadiusRatio * 0.97));
+    params.maxRadius = int(std::ceil(shortSide * o.maxRadiusRatio * 1.03));
+    params.gaugeMinValue = o.minValue;
+    params.gaugeMaxValue = o.maxValue;
+    params.angleTable = { cv::Point2d(o.startAngle, o.minValue),
+                          cv::Point2d(o.startAngle - o.sweep, o.maxValue) };
+    return params;
+}
@@ -0,0 +1,61 @@
+#ifndef SYNTHETICGAUGE_H
+#define SYNTHETICGAUGE_H
+
+#include "GaugeCore.h"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+// 合成表盘的取值范围。每张图在范围内随机取半径、指针位置、透视、模糊、噪声和光照
+struct SyntheticGaugeOptions
+{
+    cv::Size outputSize = cv::Size(613, 580);   // 正视表盘尺寸，即透视变换后的尺寸
+    cv::Size imageSize = cv::Size(800, 700);    // 原图尺寸
+
+    double minRadiusRatio = 0.40;   // 表盘半径占 outputSize 短边的比例范围
+    double maxRadiusRatio = 0.47;
+
+    // 刻度：最小值在 startAngle（度，0 点在右侧，逆时针为正），顺时针扫过 sweep 到最大值
+    double startAngle = 225.0;
+    double sweep = 270.0;
+    double minValue = 0.0;
+    double maxValue = 1.6;
+    int majorTicks = 9;             // 含两端
+    int minorPerMajor = 4;
+
+    double maxSkew = 0.08;          // 四个角的随机偏移，占原图短边的比例
+    double maxBlurSigma = 1.5;
+    double maxNoiseSigma = 8.0;
+    double maxLighting = 0.5;       // 光照渐变强度，0 为均匀光照
+};
+
+// 一张合成图和它的真值
+struct SyntheticGauge
+{
+    cv::Mat image;                      // BGR 原图
+    std::vector<cv::Point2f> quad;      // 正视表盘在原图中的四个角（左上、右上、右下、左下）
+    cv::Vec3f circle;                   // 表盘圆（透视变换后坐标）
+    double needleAngle = 0.0;           // 指针角度（透视变换后坐标，度，0 点在右侧，逆时针为正）
+    double value = 0.0;                 // 真实读数
+};
+
+class SyntheticGaugeGenerator
+{
+public:
+    explicit SyntheticGaugeGenerator(const SyntheticGaugeOptions &options = SyntheticGaugeOptions());
+
+    const SyntheticGaugeOptions &options() const { return m_options; }
+
+    // 第 index 张图只由 seed 和 index 决定，可在多个线程中并发生成
+    SyntheticGauge render(uint64_t seed, uint64_t index) const;
+
+    // 识别这张图用的参数：真实的四边形、输出尺寸、包含真实半径的半径范围和与刻度一致的刻度表
+    GaugeParams params(const SyntheticGauge &gauge) const;
+
+private:
+    cv::Mat renderFace(cv::RNG &rng, SyntheticGauge &gauge) const;
+
+    SyntheticGaugeOptions m_options;
+};
+
+#endif // SYNTHETICGAUGE_H
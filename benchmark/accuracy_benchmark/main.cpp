@@ -0,0 +1,248 @@
+// 端到端精度与吞吐基准：批量生成带真值的合成表盘，跑完整的识别处理链（与 --batch 相同的 GaugeCore::process），
+// 同时报告读数误差分位数、漏检率、单帧延迟分位数和吞吐，保证每次性能改动都经过精度检查。
+// 用法：accuracy_benchmark [-n 张数] [-t 线程数] [--seed n] [--circle hough|gradient|ransac]
+//                          [--pointer hough|polar] [-w 目录] [-o 逐张结果.csv]
+//   -w 目录   同时把合成图写成 PNG，并写出 labels.csv（文件名、真实读数、指针角度、四边形）
+#include "SyntheticGauge.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct Sample
+{
+    bool found = false;
+    double value = 0.0;         // 真实读数
+    double reading = 0.0;
+    double valueError = 0.0;    // |读数 - 真值|
+    double angleError = 0.0;    // 指针角度误差（度）
+    double latencyMs = 0.0;
+};
+
+double percentile(std::vector<double> values, double p)
+{
+    if (values.empty())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    std::sort(values.begin(), values.end());
+    const size_t index = std::min(values.size() - 1, size_t(p * (values.size() - 1) + 0.5));
+    return values[index];
+}
+
+bool parseCircleMethod(const char *name, CircleDetector::Method &method)
+{
+    if (std::strcmp(name, "hough") == 0) method = CircleDetector::HoughMethod;
+    else if (std::strcmp(name, "gradient") == 0) method = CircleDetector::GradientVoteMethod;
+    else if (std::strcmp(name, "ransac") == 0) method = CircleDetector::RansacMethod;
+    else return false;
+    return true;
+}
+
+bool parsePointerMethod(const char *name, PointerDetector::Method &method)
+{
+    if (std::strcmp(name, "hough") == 0) method = PointerDetector::HoughMethod;
+    else if (std::strcmp(name, "polar") == 0) method = PointerDetector::PolarMethod;
+    else return false;
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    int count = 1000;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = 1;
+    CircleDetector::Method circleMethod = GaugeParams().circleMethod;
+    PointerDetector::Method pointerMethod = GaugeParams().pointerMethod;
+    std::string writeDir;
+    const char *outputName = nullptr;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "-n") == 0 && hasValue)
+        {
+            count = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "-t") == 0 && hasValue)
+        {
+            threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+        {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--circle") == 0 && hasValue && parseCircleMethod(argv[i + 1], circleMethod))
+        {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "--pointer") == 0 && hasValue && parsePointerMethod(argv[i + 1], pointerMethod))
+        {
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "-w") == 0 && hasValue)
+        {
+            writeDir = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "-o") == 0 && hasValue)
+        {
+            outputName = argv[++i];
+        }
+        else
+        {
+            std::fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    const SyntheticGaugeGenerator generator;
+    const SyntheticGaugeOptions &options = generator.options();
+    const double fullScale = options.maxValue - options.minValue;
+
+    FILE *labels = nullptr;
+    if (!writeDir.empty())
+    {
+        labels = std::fopen((writeDir + "/labels.csv").c_str(), "w");
+        if (!labels)
+        {
+            std::fprintf(stderr, "无法写入: %s/labels.csv\n", writeDir.c_str());
+            return 1;
+        }
+        std::fprintf(labels, "file,value,needleAngle,x1,y1,x2,y2,x3,y3,x4,y4\n");
+    }
+
+    // 分批：先并行生成一批图像（不计时），再并行识别这一批并计时，内存占用与总张数无关
+    std::vector<Sample> samples(count);
+    const int batchSize = std::max(64, threads * 8);
+    double processingSeconds = 0.0;
+    for (int batchStart = 0; batchStart < count; batchStart += batchSize)
+    {
+        const int batchEnd = std::min(count, batchStart + batchSize);
+        std::vector<SyntheticGauge> gauges(batchEnd - batchStart);
+
+        auto runParallel = [&](const std::function<void(int)> &work) {
+            std::atomic<int> next(batchStart);
+            std::vector<std::thread> pool;
+            for (int t = 0; t < threads; ++t)
+            {
+                pool.emplace_back([&]() {
+                    for (int i = next++; i < batchEnd; i = next++)
+                    {
+                        work(i);
+                    }
+                });
+            }
+            for (auto &thread : pool)
+            {
+                thread.join();
+            }
+        };
+
+        runParallel([&](int i) {
+            gauges[i - batchStart] = generator.render(seed, uint64_t(i));
+        });
+
+        const auto start = std::chrono::steady_clock::now();
+        runParallel([&](int i) {
+            const SyntheticGauge &gauge = gauges[i - batchStart];
+            GaugeParams params = generator.params(gauge);
+            params.circleMethod = circleMethod;
+            params.pointerMethod = pointerMethod;
+
+            const auto t0 = std::chrono::steady_clock::now();
+            const GaugeResult result = GaugeCore::process(gauge.image, params);
+            Sample &s = samples[i];
+            s.latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            s.value = gauge.value;
+            s.found = result.isValid();
+            if (s.found)
+            {
+                s.reading = result.reading;
+                s.valueError = std::abs(result.reading - gauge.value);
+                s.angleError = std::abs(std::remainder(result.angle - gauge.needleAngle, 360.0));
+            }
+        });
+        processingSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (labels)
+        {
+            for (int i = batchStart; i < batchEnd; ++i)
+            {
+                const SyntheticGauge &gauge = gauges[i - batchStart];
+                char name[64];
+                std::snprintf(name, sizeof(name), "gauge_%06d.png", i);
+                cv::imwrite(writeDir + "/" + name, gauge.image);
+                std::fprintf(labels, "%s,%.6f,%.4f", name, gauge.value, gauge.needleAngle);
+                for (const auto &pt : gauge.quad)
+                {
+                    std::fprintf(labels, ",%.3f,%.3f", pt.x, pt.y);
+                }
+                std::fprintf(labels, "\n");
+            }
+        }
+    }
+    if (labels)
+    {
+        std::fclose(labels);
+    }
+
+    if (outputName)
+    {
+        FILE *file = std::fopen(outputName, "w");
+        if (!file)
+        {
+            std::fprintf(stderr, "无法写入结果文件: %s\n", outputName);
+            return 1;
+        }
+        std::fprintf(file, "index,found,value,reading,valueError,angleError,ms\n");
+        for (int i = 0; i < count; ++i)
+        {
+            const Sample &s = samples[i];
+            std::fprintf(file, "%d,%d,%.6f,%.6f,%.6f,%.4f,%.3f\n", i, s.found ? 1 : 0, s.value,
+                         s.reading, s.valueError, s.angleError, s.latencyMs);
+        }
+        std::fclose(file);
+    }
+
+    std::vector<double> valueErrors;
+    std::vector<double> angleErrors;
+    std::vector<double> latencies;
+    for (const Sample &s : samples)
+    {
+        latencies.push_back(s.latencyMs);
+        if (s.found)
+        {
+            valueErrors.push_back(s.valueError / fullScale * 100.0);
+            angleErrors.push_back(s.angleError);
+        }
+    }
+
+    const int missed = count - int(valueErrors.size());
+    std::printf("images %d, threads %d, seed %llu, circle %d, pointer %d\n",
+                count, threads, (unsigned long long)seed, int(circleMethod), int(pointerMethod));
+    std::printf("missed      %d (%.2f%%)\n", missed, 100.0 * missed / count);
+    std::printf("error %%FS   p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+                percentile(valueErrors, 0.5), percentile(valueErrors, 0.9),
+                percentile(valueErrors, 0.99), percentile(valueErrors, 1.0));
+    std::printf("angle deg   p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+                percentile(angleErrors, 0.5), percentile(angleErrors, 0.9),
+                percentile(angleErrors, 0.99), percentile(angleErrors, 1.0));
+    std::printf("latency ms  p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+                percentile(latencies, 0.5), percentile(latencies, 0.9),
+                percentile(latencies, 0.99), percentile(latencies, 1.0));
+    std::printf("throughput  %.1f images/s\n", count / std::max(1e-9, processingSeconds));
+    return 0;
+}
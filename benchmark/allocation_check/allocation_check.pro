@@ -0,0 +1,56 @@
+# MultiGaugeReader 依赖 GaugeProfile（QString、QFile），需要 QtCore
+QT       = core
+QT       -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = allocation_check
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../accuracy_benchmark/SyntheticGauge.cpp \
+    ../../CircleDetector.cpp \
+    ../../FramePool.cpp \
+    ../../GaugeCore.cpp \
+    ../../GaugePipeline.cpp \
+    ../../GaugeProfile.cpp \
+    ../../GaussianBlurEngine.cpp \
+    ../../GeometryLock.cpp \
+    ../../GrayWarpKernel.cpp \
+    ../../MultiGaugeReader.cpp \
+    ../../NeedleTracker.cpp \
+    ../../ParallelCanny.cpp \
+    ../../PerspectiveMap.cpp \
+    ../../PointerDetector.cpp \
+    ../../SimdDispatch.cpp \
+    ../../StageExecutor.cpp \
+    ../../StageTimer.cpp
+
+HEADERS += \
+    ../accuracy_benchmark/SyntheticGauge.h \
+    ../../CircleDetector.h \
+    ../../FramePool.h \
+    ../../GaugeCore.h \
+    ../../GaugePipeline.h \
+    ../../GaugeProfile.h \
+    ../../GaussianBlurEngine.h \
+    ../../GeometryLock.h \
+    ../../GrayWarpKernel.h \
+    ../../MemoryUsage.h \
+    ../../MultiGaugeReader.h \
+    ../../NeedleTracker.h \
+    ../../ParallelCanny.h \
+    ../../PerspectiveMap.h \
+    ../../PointerDetector.h \
+    ../../SimdDispatch.h \
+    ../../SpscQueue.h \
+    ../../StageCache.h \
+    ../../StageExecutor.h \
+    ../../StageTimer.h
+
+INCLUDEPATH += D:/opencv_lib/include
+LIBS += D:/opencv_lib/lib/libopencv_*.a
@@ -0,0 +1,436 @@
+// 逐帧分配检查：用同尺寸的合成帧连续跑各条处理路径，统计预热后整个进程的堆分配次数，
+// 超出允许值时返回非 0，用来防止改动重新引入逐帧分配。
+// 计数来自替换的全局 operator new：cv::Mat 的数据块由 OpenCV 的 fastMalloc 分配，
+// 但每次分配都同时 new 一个 UMatData，所以同样计入；std::vector、std::function 等都直接计入。
+// 本程序自己的路径允许值为 0；彩色透视图要经过 cv::remap 和 cv::cvtColor，
+// OpenCV 在其中每次调用都会分配临时缓冲，这条路径以单独调用这两步测得的次数为每帧上限。
+// 同时检查多表模式下表的数量超过映射表缓存容量时，各表的透视映射表只在登记时构建一次。
+// 所有检查先单线程跑一轮，再用多个 OpenCV 线程跑一轮：多线程时 OpenCV 线程池每次 parallel_for_
+// 都分配任务对象，分配次数只作参考，但结果必须与单线程逐项一致（分块 Canny 的边缘图和梯度逐位一致）。
+// 用法：allocation_check [-n 帧数] [-w 预热帧数] [-t 多线程一轮的线程数]
+//   -w 至少要覆盖处理链缓存和缓冲区池填满所需的 2 帧，默认 5
+//   -t 默认全部核数，至少 2
+#include "GaugePipeline.h"
+#include "MultiGaugeReader.h"
+#include "PerspectiveMap.h"
+#include "StageExecutor.h"
+#include "../accuracy_benchmark/SyntheticGauge.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// --------------------堆分配计数--------------------
+namespace
+{
+std::atomic<uint64_t> g_heapAllocations(0);
+
+void *countedAllocate(std::size_t size)
+{
+    g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+uint64_t heapAllocations()
+{
+    return g_heapAllocations.load(std::memory_order_relaxed);
+}
+}
+
+void *operator new(std::size_t size)
+{
+    if (void *p = countedAllocate(size))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+
+struct Check
+{
+    const char *name;
+    uint64_t warmUp = 0;        // 预热结束时的计数（分配或构建次数）
+    uint64_t total = 0;         // 全部帧处理完的计数
+    uint64_t allowed = 0;       // 预热后允许的增量
+    bool heapCount = true;      // 计数为堆分配次数（多线程时只作参考）；否则为映射表构建次数
+    std::vector<GaugeResult> results;   // 按帧（多表时按帧、表）顺序的识别结果
+    size_t mismatches = 0;      // 与单线程结果不一致的项数
+
+    explicit Check(const char *checkName) : name(checkName) {}
+};
+
+bool sameResult(const GaugeResult &a, const GaugeResult &b)
+{
+    // 未找到指针时读数为 NaN，按位比较
+    return a.circleFound == b.circleFound && a.circle == b.circle && a.pointerFound == b.pointerFound
+            && a.pointerLine == b.pointerLine && std::memcmp(&a.angle, &b.angle, sizeof(double)) == 0
+            && std::memcmp(&a.reading, &b.reading, sizeof(double)) == 0;
+}
+
+// 逐行比较，不借助会分配临时图的 cv::compare
+bool sameImage(const cv::Mat &a, const cv::Mat &b)
+{
+    if (a.size() != b.size() || a.type() != b.type())
+    {
+        return false;
+    }
+    const size_t rowBytes = a.cols * a.elemSize();
+    for (int y = 0; y < a.rows; ++y)
+    {
+        if (std::memcmp(a.ptr(y), b.ptr(y), rowBytes) != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 单线程时分配次数不超过允许值；多线程时只要求结果与单线程一致（构建次数仍然检查）
+bool report(const Check &check, int threads)
+{
+    const uint64_t after = check.total - check.warmUp;
+    const bool countChecked = threads == 1 || !check.heapCount;
+    const bool ok = (!countChecked || after <= check.allowed) && check.mismatches == 0;
+    std::printf("%-28s %2d thread(s)  warm-up %6llu  after %4llu", check.name, threads,
+                (unsigned long long)check.warmUp, (unsigned long long)after);
+    if (countChecked)
+    {
+        std::printf(" (allowed %llu)", (unsigned long long)check.allowed);
+    }
+    else
+    {
+        std::printf(" (not checked)");
+    }
+    std::printf("  mismatches %zu  %s\n", check.mismatches, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+// OpenCV 的 remap 每次调用都为分块坐标分配临时缓冲，不属于本程序。
+// 单独调用透视变换和灰度转换（输出和映射表已就绪后）测得的分配次数，作为彩色透视路径每帧的上限
+uint64_t colorWarpAllocations(const cv::Mat &image, const GaugeParams &params)
+{
+    cv::Mat perspective;
+    cv::Mat gray;
+    uint64_t allocations = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        const uint64_t before = heapAllocations();
+        GaugeCore::applyPerspectiveTransform(image, perspective, params);
+        GaugeCore::convertToGray(perspective, gray);
+        allocations = heapAllocations() - before;
+    }
+    return allocations;
+}
+
+// 模拟视频流：每帧一个新的 sourceId，参数不变。colorWarp 为 false 时灰度图由融合内核直接生成。
+// 叠加图绘制只计缓冲区池的分配：cv::circle、cv::line 等绘制函数内部会为轮廓点分配数组，不属于处理链
+Check checkPipeline(const char *name, int outputs, bool colorWarp, const std::vector<cv::Mat> &images,
+                    const GaugeParams &params, int warmUp, int frames)
+{
+    GaugePipeline pipeline;
+    pipeline.setRetainedOutputs(outputs);
+    pipeline.setColorWarpEnabled(colorWarp);
+    // 界面保留上一帧的结果和叠加图，直到新结果送达
+    GaugeFrame frame;
+    cv::Mat circleImage;
+    cv::Mat lineImage;
+    FramePool overlayPool;
+    uint64_t drawing = 0;
+
+    Check check(name);
+    check.results.reserve(size_t(warmUp + frames));
+    for (int i = 0; i < warmUp + frames; ++i)
+    {
+        if (i == warmUp)
+        {
+            check.warmUp = heapAllocations() - drawing + overlayPool.allocations();
+        }
+        pipeline.setSource(images[i % images.size()], uint64_t(i + 1));
+        pipeline.run(params, frame);
+        check.results.push_back(frame.result);
+        if (outputs != GaugePipeline::NoOutputs)
+        {
+            const uint64_t before = heapAllocations();
+            GaugeCore::drawOverlays(frame, true, true, circleImage, lineImage, &overlayPool);
+            drawing += heapAllocations() - before;
+        }
+    }
+    check.total = heapAllocations() - drawing + overlayPool.allocations();
+    return check;
+}
+
+// 分块 Canny：当前线程数下的边缘图、梯度与单线程逐位一致；不输出梯度时用内部工作内存的结果也一致
+Check checkEdges(const std::vector<cv::Mat> &images, const GaugeParams &params, int warmUp, int frames)
+{
+    const int threads = cv::getNumThreads();
+    std::vector<cv::Mat> blurred(images.size());
+    std::vector<cv::Mat> referenceEdges(images.size());
+    std::vector<EdgeGradients> referenceGradients(images.size());
+    cv::setNumThreads(1);
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        GaugeCore::warpToBlurred(images[i], blurred[i], params);
+        GaugeCore::detectEdges(blurred[i], referenceEdges[i], params, &referenceGradients[i]);
+    }
+    cv::setNumThreads(threads);
+
+    cv::Mat edges;
+    cv::Mat plainEdges;
+    EdgeGradients gradients;
+    Check check("edges");
+    for (int i = 0; i < warmUp + frames; ++i)
+    {
+        if (i == warmUp)
+        {
+            check.warmUp = heapAllocations();
+        }
+        const size_t k = i % images.size();
+        GaugeCore::detectEdges(blurred[k], edges, params, &gradients);
+        GaugeCore::detectEdges(blurred[k], plainEdges, params);
+        const EdgeGradients &reference = referenceGradients[k];
+        if (!sameImage(edges, referenceEdges[k]) || !sameImage(plainEdges, referenceEdges[k])
+                || !sameImage(gradients.dx, reference.dx) || !sameImage(gradients.dy, reference.dy)
+                || !sameImage(gradients.magnitude, reference.magnitude))
+        {
+            ++check.mismatches;
+        }
+    }
+    check.total = heapAllocations();
+    return check;
+}
+
+// gaugeCount 块表，四边形各不相同（多于映射表缓存的 4 个槽位时缓存装不下）
+void addGauges(MultiGaugeReader &reader, const GaugeParams &params, int gaugeCount)
+{
+    for (int i = 0; i < gaugeCount; ++i)
+    {
+        GaugeSpec gauge = { "gauge" + std::to_string(i), params };
+        for (cv::Point2f &point : gauge.params.sourcePoints)
+        {
+            point += cv::Point2f(float(i), float(i));
+        }
+        reader.addGauge(gauge);
+    }
+}
+
+// 多表并行处理，各表的池、锁定和跟踪状态互不影响；结果写入复用的数组
+Check checkMultiGauge(const std::vector<cv::Mat> &images, const GaugeParams &params, int warmUp, int frames)
+{
+    const int gaugeCount = 8;
+    MultiGaugeReader reader;
+    addGauges(reader, params, gaugeCount);
+    std::vector<GaugeResult> results;
+
+    Check check("multi-gauge (8 gauges)");
+    check.results.reserve(size_t(warmUp + frames) * gaugeCount);
+    for (int i = 0; i < warmUp + frames; ++i)
+    {
+        if (i == warmUp)
+        {
+            check.warmUp = heapAllocations();
+        }
+        reader.process(images[i % images.size()], results);
+        check.results.insert(check.results.end(), results.begin(), results.end());
+    }
+    check.total = heapAllocations();
+    return check;
+}
+
+// 登记时各构建一次映射表，之后逐帧处理不再构建
+Check checkMultiGaugeMaps(const std::vector<cv::Mat> &images, const GaugeParams &params, int frames)
+{
+    PerspectiveMapCache::instance().clear();
+    const uint64_t before = PerspectiveMapCache::instance().buildCount();
+
+    MultiGaugeReader reader;
+    addGauges(reader, params, 8);
+    std::vector<GaugeResult> results;
+
+    Check check("multi-gauge maps (8 gauges)");
+    check.heapCount = false;
+    check.warmUp = PerspectiveMapCache::instance().buildCount() - before;
+    for (int i = 0; i < frames; ++i)
+    {
+        reader.process(images[i % images.size()], results);
+    }
+    check.total = PerspectiveMapCache::instance().buildCount() - before;
+    return check;
+}
+
+// 流水执行器在开始前按在途帧数分配好缓冲区。线程启动等一次性分配都在前几帧送达之前完成，
+// 从第 warmUp 帧送达 sink 起到最后一帧送达为止，各阶段线程都不应再分配
+Check checkExecutor(const std::vector<cv::Mat> &images, const GaugeParams &params, int warmUp, int frames)
+{
+    StageExecutor executor(4);
+    executor.setParameters(params);
+
+    const int count = warmUp + frames;
+    int next = 0;
+    Check check("stage executor");
+    check.results.resize(size_t(count));
+    executor.run([&](StageExecutor::Item &item) {
+        if (next >= count)
+        {
+            return false;
+        }
+        item.image = images[next % images.size()];
+        item.index = next++;
+        return true;
+    }, [&](const StageExecutor::Item &item) {
+        check.results[size_t(item.index)] = item.result;
+        if (item.index == warmUp - 1)
+        {
+            check.warmUp = heapAllocations();
+        }
+        else if (item.index == count - 1)
+        {
+            check.total = heapAllocations();
+        }
+    });
+    return check;
+}
+
+// 同一组检查，在当前的 OpenCV 线程数下跑一轮
+std::vector<Check> runChecks(const std::vector<cv::Mat> &images, const GaugeParams &params,
+                             const GaugeParams &ransacParams, int warmUp, int frames)
+{
+    std::vector<Check> checks;
+    checks.push_back(checkPipeline("pipeline (reading only)", GaugePipeline::NoOutputs, false,
+                                   images, params, warmUp, frames));
+    checks.push_back(checkPipeline("pipeline (gray outputs)", GaugePipeline::AllOutputs, false,
+                                   images, params, warmUp, frames));
+    Check colorWarp = checkPipeline("pipeline (color warp)", GaugePipeline::AllOutputs, true,
+                                    images, params, warmUp, frames);
+    colorWarp.allowed = colorWarpAllocations(images[0], params) * uint64_t(frames);
+    checks.push_back(colorWarp);
+    checks.push_back(checkPipeline("pipeline (ransac)", GaugePipeline::NoOutputs, false,
+                                   images, ransacParams, warmUp, frames));
+    checks.push_back(checkEdges(images, params, warmUp, frames));
+    checks.push_back(checkMultiGauge(images, params, warmUp, frames));
+    checks.push_back(checkMultiGaugeMaps(images, params, frames));
+    checks.push_back(checkExecutor(images, params, warmUp, frames));
+    return checks;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 100;
+    int warmUp = 5;
+    int threads = std::max(2, cv::getNumThreads());
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "-n") == 0 && hasValue)
+        {
+            frames = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "-w") == 0 && hasValue)
+        {
+            warmUp = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "-t") == 0 && hasValue)
+        {
+            threads = std::max(2, std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::fprintf(stderr, "未知参数: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // 几张不同读数的合成图轮流使用，固定机位：都用第一张的参数
+    const SyntheticGaugeGenerator generator;
+    std::vector<cv::Mat> images;
+    for (int i = 0; i < 4; ++i)
+    {
+        images.push_back(generator.render(1, uint64_t(i)).image);
+    }
+    const GaugeParams params = generator.params(generator.render(1, 0));
+    // 换成 RANSAC 圆检测的参数，覆盖另一条检测路径
+    GaugeParams ransacParams = params;
+    ransacParams.circleMethod = CircleDetector::RansacMethod;
+
+    // 单线程一轮检查分配次数，并作为多线程一轮的参考结果
+    cv::setNumThreads(1);
+    const std::vector<Check> reference = runChecks(images, params, ransacParams, warmUp, frames);
+    cv::setNumThreads(threads);
+    std::vector<Check> parallel = runChecks(images, params, ransacParams, warmUp, frames);
+    for (size_t i = 0; i < parallel.size(); ++i)
+    {
+        const std::vector<GaugeResult> &expected = reference[i].results;
+        const std::vector<GaugeResult> &actual = parallel[i].results;
+        for (size_t k = 0; k < std::max(expected.size(), actual.size()); ++k)
+        {
+            if (k >= expected.size() || k >= actual.size() || !sameResult(expected[k], actual[k]))
+            {
+                ++parallel[i].mismatches;
+            }
+        }
+    }
+
+    bool ok = true;
+    for (const Check &check : reference)
+    {
+        ok &= report(check, 1);
+    }
+    for (const Check &check : parallel)
+    {
+        ok &= report(check, threads);
+    }
+    return ok ? 0 : 1;
+}
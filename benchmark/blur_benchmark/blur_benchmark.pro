@@ -0,0 +1,22 @@
+QT       -= core gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle qt
+
+TARGET = blur_benchmark
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../GaussianBlurEngine.cpp \
+    ../../SimdDispatch.cpp
+
+HEADERS += \
+    ../../GaussianBlurEngine.h \
+    ../../SimdDispatch.h \
+    ../../StageCache.h
+
+INCLUDEPATH += D:/opencv_lib/include
+LIBS += D:/opencv_lib/lib/libopencv_*.a
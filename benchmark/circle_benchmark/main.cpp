@@ -0,0 +1,133 @@
+// 表盘圆检测基准：对比全分辨率与金字塔模式的耗时和结果偏差。
+// 用法：circle_benchmark [图像 ...]
+// 图像按默认 GaugeParams 做透视变换和模糊；不给图像时使用合成的表盘。
+// 每种检测方法以全分辨率结果为基准，输出各金字塔层数的加速比、圆心偏差和半径偏差
+#include "GaugeCore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+
+const int Repeats = 20;
+
+// 合成表盘：浅色表盘、深色外圈、刻度和指针，叠加噪声
+cv::Mat syntheticDial(const GaugeParams &params)
+{
+    const cv::Size size(params.outputWidth, params.outputHeight);
+    const cv::Point center(size.width / 2 + 3, size.height / 2 - 2);
+    const int radius = (params.minRadius + params.maxRadius) / 2 - 20;
+
+    cv::Mat image(size, CV_8UC1, cv::Scalar(70));
+    cv::circle(image, center, radius, cv::Scalar(225), -1, cv::LINE_AA);
+    cv::circle(image, center, radius, cv::Scalar(25), 8, cv::LINE_AA);
+    for (int i = 0; i < 60; ++i)
+    {
+        const double a = i * CV_PI / 30;
+        const double inner = radius * (i % 5 == 0 ? 0.85 : 0.92);
+        cv::line(image,
+                 center + cv::Point(cvRound(inner * std::cos(a)), cvRound(inner * std::sin(a))),
+                 center + cv::Point(cvRound(radius * 0.97 * std::cos(a)), cvRound(radius * 0.97 * std::sin(a))),
+                 cv::Scalar(30), i % 5 == 0 ? 3 : 1, cv::LINE_AA);
+    }
+    const double needle = 0.7;
+    cv::line(image, center,
+             center + cv::Point(cvRound(radius * 0.8 * std::cos(needle)), cvRound(-radius * 0.8 * std::sin(needle))),
+             cv::Scalar(20), 5, cv::LINE_AA);
+
+    cv::Mat noise(size, CV_8UC1);
+    cv::randn(noise, 0, 6);
+    cv::add(image, noise, image);
+    return image;
+}
+
+double medianMs(std::vector<double> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void benchmark(const char *name, const cv::Mat &blurred, const GaugeParams &baseParams)
+{
+    cv::Mat edges;
+    EdgeGradients gradients;
+    GaugeCore::detectEdges(blurred, edges, baseParams, &gradients);
+
+    std::printf("%s (%dx%d)\n", name, blurred.cols, blurred.rows);
+    std::printf("  %-13s %-6s %10s %8s %10s %10s %8s\n",
+                "method", "level", "ms", "speedup", "centerErr", "radiusErr", "support");
+
+    const CircleDetector::Method methods[] = { CircleDetector::HoughMethod, CircleDetector::GradientVoteMethod,
+                                                 CircleDetector::RansacMethod };
+    for (CircleDetector::Method method : methods)
+    {
+        GaugeResult reference;
+        double referenceMs = 0;
+        for (int levels = 0; levels <= CircleDetector::MaxPyramidLevels; ++levels)
+        {
+            GaugeParams params = baseParams;
+            params.circleMethod = method;
+            params.circlePyramidLevels = levels;
+
+            GaugeResult result;
+            std::vector<double> samples;
+            for (int i = 0; i < Repeats; ++i)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                GaugeCore::detectCircles(blurred, edges, gradients, params, result);
+                samples.push_back(std::chrono::duration<double, std::milli>(
+                                      std::chrono::steady_clock::now() - start).count());
+            }
+            const double ms = medianMs(samples);
+            if (levels == 0)
+            {
+                reference = result;
+                referenceMs = ms;
+            }
+
+            const char *methodName = method == CircleDetector::HoughMethod ? "hough"
+                                     : method == CircleDetector::GradientVoteMethod ? "gradientVote" : "ransac";
+            if (!result.circleFound || !reference.circleFound)
+            {
+                std::printf("  %-13s 1/%-4d %10.3f %7.2fx %10s %10s %8s\n", methodName, 1 << levels,
+                            ms, referenceMs / ms, "-", "-", result.circleFound ? "" : "miss");
+                continue;
+            }
+            const double centerErr = cv::norm(cv::Point2f(result.circle[0], result.circle[1])
+                    - cv::Point2f(reference.circle[0], reference.circle[1]));
+            const double radiusErr = std::abs(result.circle[2] - reference.circle[2]);
+            std::printf("  %-13s 1/%-4d %10.3f %7.2fx %10.2f %10.2f %8.2f\n", methodName, 1 << levels,
+                        ms, referenceMs / ms, centerErr, radiusErr, result.circleSupport);
+        }
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    GaugeParams params;
+
+    if (argc < 2)
+    {
+        cv::Mat blurred;
+        GaugeCore::applyGaussianBlur(syntheticDial(params), blurred, params);
+        benchmark("synthetic", blurred, params);
+        return 0;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        cv::Mat image = cv::imread(argv[i], cv::IMREAD_COLOR);
+        if (image.empty())
+        {
+            std::fprintf(stderr, "LOAD_ERROR %s\n", argv[i]);
+            continue;
+        }
+        cv::Mat blurred;
+        GaugeCore::warpToBlurred(image, blurred, params);
+        benchmark(argv[i], blurred, params);
+    }
+    return 0;
+}
@@ -0,0 +1,342 @@
+// 处理链逐阶段基准：分别计时透视变换、灰度、模糊、边缘、圆检测、指针检测和读数计算，
+// 每个阶段同时测当前实现和对应的原始 OpenCV 调用，便于对比优化效果、发现性能回退。
+// 用法：stage_benchmark [-r 重复次数] [-s 缩放列表] [-t 线程数列表] [-o 结果文件] [图像 ...]
+//   -s 0.5,1,2   输入分辨率相对默认参数（约 680x640 原图、612x580 输出）的缩放，参数随之缩放
+//   -t 1,2,4     cv::setNumThreads 的取值，默认 1 和全部核数
+// 不给图像时使用合成的表盘。结果为 JSON（默认输出到标准输出），每条记录一个“输入、分辨率、线程数、阶段、实现”，
+// 可读的汇总表输出到标准错误
+#include "GaugeCore.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Record
+{
+    std::string input;
+    cv::Size sourceSize;
+    cv::Size outputSize;
+    int threads;
+    std::string stage;
+    std::string impl;       // "gauge"：当前实现；"opencv"：原始 OpenCV 调用
+    double medianMs;
+    double minMs;
+    double p90Ms;
+    int repeats;
+};
+
+std::vector<double> parseList(const char *text)
+{
+    std::vector<double> values;
+    for (const char *p = text; *p; )
+    {
+        char *end = nullptr;
+        const double value = std::strtod(p, &end);
+        if (end == p)
+        {
+            break;
+        }
+        values.push_back(value);
+        p = (*end == ',') ? end + 1 : end;
+    }
+    return values;
+}
+
+// 先预热一次（分配输出、构建映射表和核缓存），再逐次计时
+Record measure(int repeats, const std::function<void()> &fn)
+{
+    fn();
+    std::vector<double> samples;
+    for (int i = 0; i < repeats; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        samples.push_back(std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Record record;
+    record.medianMs = samples[samples.size() / 2];
+    record.minMs = samples.front();
+    record.p90Ms = samples[std::min(samples.size() - 1, samples.size() * 9 / 10)];
+    record.repeats = repeats;
+    return record;
+}
+
+// 合成原图：默认四个源点围成的区域内画一块浅色表盘，带刻度、指针和噪声
+cv::Mat syntheticSource()
+{
+    const cv::Size size(680, 640);
+    const cv::Point center(338, 305);
+    const int radius = 285;
+
+    cv::Mat image(size, CV_8UC3, cv::Scalar(60, 70, 80));
+    cv::circle(image, center, radius, cv::Scalar(225, 228, 230), -1, cv::LINE_AA);
+    cv::circle(image, center, radius, cv::Scalar(25, 25, 25), 8, cv::LINE_AA);
+    for (int i = 0; i < 60; ++i)
+    {
+        const double a = i * CV_PI / 30;
+        const double inner = radius * (i % 5 == 0 ? 0.85 : 0.92);
+        cv::line(image,
+                 center + cv::Point(cvRound(inner * std::cos(a)), cvRound(inner * std::sin(a))),
+                 center + cv::Point(cvRound(radius * 0.97 * std::cos(a)), cvRound(radius * 0.97 * std::sin(a))),
+                 cv::Scalar(30, 30, 30), i % 5 == 0 ? 3 : 1, cv::LINE_AA);
+    }
+    const double needle = 0.7;
+    cv::line(image, center,
+             center + cv::Point(cvRound(radius * 0.8 * std::cos(needle)), cvRound(-radius * 0.8 * std::sin(needle))),
+             cv::Scalar(20, 20, 200), 5, cv::LINE_AA);
+
+    cv::Mat noise(size, CV_8UC3);
+    cv::randn(noise, 0, 6);
+    cv::add(image, noise, image);
+    return image;
+}
+
+// 原图和所有与像素尺寸有关的参数一起缩放
+GaugeParams scaledParams(double scale)
+{
+    GaugeParams params;
+    for (auto &pt : params.sourcePoints)
+    {
+        pt *= float(scale);
+    }
+    params.outputWidth = cvRound(params.outputWidth * scale);
+    params.outputHeight = cvRound(params.outputHeight * scale);
+    params.minRadius = cvRound(params.minRadius * scale);
+    params.maxRadius = cvRound(params.maxRadius * scale);
+    params.minLineLength = cvRound(params.minLineLength * scale);
+    params.maxLineGap = cvRound(params.maxLineGap * scale);
+    // sigma 按比例放大，不同分辨率下的平滑程度相同
+    params.sigmaX *= scale;
+    params.sigmaY *= scale;
+    return params;
+}
+
+void runCase(const std::string &input, const cv::Mat &original, double scale, int threads, int repeats,
+             std::vector<Record> &records)
+{
+    cv::setNumThreads(threads);
+
+    cv::Mat source;
+    cv::resize(original, source, cv::Size(), scale, scale, scale < 1.0 ? cv::INTER_AREA : cv::INTER_LINEAR);
+    const GaugeParams params = scaledParams(scale);
+    const cv::Size outputSize(params.outputWidth, params.outputHeight);
+
+    // 各阶段的输入取自一次完整处理的中间结果，只计时本阶段
+    GaugeFrame frame;
+    GaugeCore::process(source, params, &frame);
+
+    auto add = [&](const char *stage, const char *impl, const std::function<void()> &fn) {
+        Record record = measure(repeats, fn);
+        record.input = input;
+        record.sourceSize = source.size();
+        record.outputSize = outputSize;
+        record.threads = threads;
+        record.stage = stage;
+        record.impl = impl;
+        records.push_back(record);
+        std::fprintf(stderr, "  %-12s %-7s %9.3f ms  (min %.3f, p90 %.3f)\n",
+                     stage, impl, record.medianMs, record.minMs, record.p90Ms);
+    };
+
+    std::fprintf(stderr, "%s %dx%d -> %dx%d, %d thread(s), circle %s, pointer %s\n",
+                 input.c_str(), source.cols, source.rows, outputSize.width, outputSize.height, threads,
+                 frame.result.circleFound ? "found" : "miss", frame.result.pointerFound ? "found" : "miss");
+
+    // 透视变换
+    cv::Mat perspective;
+    add("perspective", "gauge", [&]() { GaugeCore::applyPerspectiveTransform(source, perspective, params); });
+    const cv::Mat matrix = cv::getPerspectiveTransform(params.sourcePoints, std::vector<cv::Point2f>{
+            cv::Point2f(0, 0), cv::Point2f(float(outputSize.width), 0),
+            cv::Point2f(float(outputSize.width), float(outputSize.height)), cv::Point2f(0, float(outputSize.height)) });
+    add("perspective", "opencv", [&]() { cv::warpPerspective(source, perspective, matrix, outputSize); });
+
+    // 灰度
+    cv::Mat gray;
+    add("gray", "gauge", [&]() { GaugeCore::convertToGray(frame.perspective, gray); });
+    add("gray", "opencv", [&]() { cv::cvtColor(frame.perspective, gray, cv::COLOR_BGR2GRAY); });
+
+    // 融合路径：透视变换 + 灰度（+ 模糊）一次完成，没有对应的单个 OpenCV 调用
+    add("warpToGray", "gauge", [&]() { GaugeCore::warpToGray(source, gray, params); });
+    cv::Mat blurred;
+    add("warpToBlurred", "gauge", [&]() { GaugeCore::warpToBlurred(source, blurred, params); });
+
+    // 模糊
+    add("blur", "gauge", [&]() { GaugeCore::applyGaussianBlur(frame.gray, blurred, params); });
+    add("blur", "opencv", [&]() { cv::GaussianBlur(frame.gray, blurred, cv::Size(GaugeCore::GaugeBlurSize, GaugeCore::GaugeBlurSize),
+                                                   params.sigmaX, params.sigmaY); });
+
+    // 边缘（当前实现同时输出后续阶段复用的梯度）
+    cv::Mat edges;
+    EdgeGradients gradients;
+    add("edges", "gauge", [&]() { GaugeCore::detectEdges(frame.blurred, edges, params, &gradients); });
+    add("edges", "opencv", [&]() { cv::Canny(frame.blurred, edges, params.cannyThreshold1, params.cannyThreshold2); });
+
+    // 圆检测：当前默认方法对比 cv::HoughCircles
+    GaugeResult result;
+    add("circles", "gauge", [&]() {
+        GaugeCore::detectCircles(frame.blurred, frame.edges, frame.gradients, params, result);
+    });
+    GaugeParams houghParams = params;
+    houghParams.circleMethod = CircleDetector::HoughMethod;
+    add("circles", "opencv", [&]() {
+        GaugeCore::detectCircles(frame.blurred, frame.edges, frame.gradients, houghParams, result);
+    });
+
+    // 指针检测：极坐标展开对比 cv::HoughLinesP，都以完整处理得到的圆为输入
+    if (frame.result.circleFound && frame.result.pointerRoi.area() > 0)
+    {
+        add("lines", "gauge", [&]() {
+            result = frame.result;
+            GaugeCore::detectLines(frame.edges, frame.gradients, params, result);
+        });
+        // 原始调用：圆的外接正方形内的边缘直接做 cv::HoughLinesP 取最长线段，不做梯度方向过滤
+        const cv::Mat roiEdges = frame.edges(frame.result.pointerRoi);
+        std::vector<cv::Vec4i> lines;
+        cv::Vec4i longest;
+        add("lines", "opencv", [&]() {
+            cv::HoughLinesP(roiEdges, lines, 1, CV_PI/180, 30, params.minLineLength, params.maxLineGap);
+            double maxLength = 0;
+            for (const cv::Vec4i &line : lines)
+            {
+                const double length = std::hypot(double(line[2] - line[0]), double(line[3] - line[1]));
+                if (length > maxLength)
+                {
+                    maxLength = length;
+                    longest = line;
+                }
+            }
+        });
+    }
+
+    add("analyze", "gauge", [&]() {
+        result = frame.result;
+        GaugeCore::analyzeGauge(params, result);
+    });
+
+    add("total", "gauge", [&]() { GaugeCore::process(source, params); });
+}
+
+std::string jsonEscape(const std::string &text)
+{
+    std::string out;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+void writeJson(FILE *file, const std::vector<Record> &records)
+{
+    std::fprintf(file, "[\n");
+    for (size_t i = 0; i < records.size(); ++i)
+    {
+        const Record &r = records[i];
+        std::fprintf(file,
+                     "  {\"input\": \"%s\", \"sourceWidth\": %d, \"sourceHeight\": %d, "
+                     "\"outputWidth\": %d, \"outputHeight\": %d, \"threads\": %d, "
+                     "\"stage\": \"%s\", \"impl\": \"%s\", "
+                     "\"medianMs\": %.4f, \"minMs\": %.4f, \"p90Ms\": %.4f, \"repeats\": %d}%s\n",
+                     jsonEscape(r.input).c_str(), r.sourceSize.width, r.sourceSize.height,
+                     r.outputSize.width, r.outputSize.height, r.threads,
+                     r.stage.c_str(), r.impl.c_str(), r.medianMs, r.minMs, r.p90Ms, r.repeats,
+                     i + 1 < records.size() ? "," : "");
+    }
+    std::fprintf(file, "]\n");
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    int repeats = 20;
+    std::vector<double> scales = { 0.5, 1.0, 2.0 };
+    std::vector<double> threadCounts = { 1.0, double(cv::getNumberOfCPUs()) };
+    const char *outputName = nullptr;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "-r") == 0 && hasValue)
+        {
+            repeats = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "-s") == 0 && hasValue)
+        {
+            scales = parseList(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "-t") == 0 && hasValue)
+        {
+            threadCounts = parseList(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "-o") == 0 && hasValue)
+        {
+            outputName = argv[++i];
+        }
+        else
+        {
+            inputs.push_back(argv[i]);
+        }
+    }
+    // 全部核数为 1 时不重复测同一种线程数
+    std::sort(threadCounts.begin(), threadCounts.end());
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    std::vector<std::pair<std::string, cv::Mat>> images;
+    if (inputs.empty())
+    {
+        images.push_back(std::make_pair(std::string("synthetic"), syntheticSource()));
+    }
+    for (const auto &name : inputs)
+    {
+        cv::Mat image = cv::imread(name, cv::IMREAD_COLOR);
+        if (image.empty())
+        {
+            std::fprintf(stderr, "LOAD_ERROR %s\n", name.c_str());
+            continue;
+        }
+        images.push_back(std::make_pair(name, image));
+    }
+
+    std::vector<Record> records;
+    for (const auto &image : images)
+    {
+        for (double scale : scales)
+        {
+            for (double threads : threadCounts)
+            {
+                runCase(image.first, image.second, scale, std::max(1, int(threads)), repeats, records);
+            }
+        }
+    }
+
+    FILE *file = outputName ? std::fopen(outputName, "w") : stdout;
+    if (!file)
+    {
+        std::fprintf(stderr, "无法写入结果文件: %s\n", outputName);
+        return 1;
+    }
+    writeJson(file, records);
+    if (file != stdout)
+    {
+        std::fclose(file);
+    }
+    return 0;
+}
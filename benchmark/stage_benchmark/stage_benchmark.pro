@@ -0,0 +1,39 @@
+QT       -= core gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle qt
+
+TARGET = stage_benchmark
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../CircleDetector.cpp \
+    ../../FramePool.cpp \
+    ../../GaugeCore.cpp \
+    ../../GaussianBlurEngine.cpp \
+    ../../GrayWarpKernel.cpp \
+    ../../ParallelCanny.cpp \
+    ../../PerspectiveMap.cpp \
+    ../../PointerDetector.cpp \
+    ../../SimdDispatch.cpp \
+    ../../StageTimer.cpp
+
+HEADERS += \
+    ../../CircleDetector.h \
+    ../../FramePool.h \
+    ../../GaugeCore.h \
+    ../../GaussianBlurEngine.h \
+    ../../GrayWarpKernel.h \
+    ../../MemoryUsage.h \
+    ../../ParallelCanny.h \
+    ../../PerspectiveMap.h \
+    ../../PointerDetector.h \
+    ../../SimdDispatch.h \
+    ../../StageCache.h \
+    ../../StageTimer.h
+
+INCLUDEPATH += D:/opencv_lib/include
+LIBS += D:/opencv_lib/lib/libopencv_*.a
@@ -1,9 +1,25 @@
 #include "widget.h"
+#include "BatchReader.h"
+#include "StreamReader.h"
 
 #include <QApplication>
+#include <cstring>
 
 int main(int argc, char *argv[])
 {
+    // 带 --batch / --stream 参数时以无界面模式运行，不创建 QApplication
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--batch") == 0)
+        {
+            return BatchReader::runCommandLine(argc, argv);
+        }
+        if (std::strcmp(argv[i], "--stream") == 0 || std::strncmp(argv[i], "--stream=", 9) == 0)
+        {
+            return StreamReader::runCommandLine(argc, argv);
+        }
+    }
+
     QApplication a(argc, argv);
     Widget w;
     w.show();
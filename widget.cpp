@@ -8,11 +8,26 @@ Widget::Widget(QWidget *parent)
     , ui(new Ui::Widget)
     , m_imageProcessor(new ImageProcessor(this))
     , m_stepValue(5)
+    , m_timingOverlay(nullptr)
 {
     ui->setupUi(this);
     setWindowTitle("仪表识别");
     setupConnections();
 
+    // 各阶段耗时叠加在结果图左上角，调参时可以看出是哪一步变慢
+    StageTrace::setEnabled(true);
+    m_timingOverlay = new QLabel(ui->pixelViewer_line);
+    m_timingOverlay->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_timingOverlay->setStyleSheet("QLabel { background-color: rgba(0, 0, 0, 160); color: white;"
+                                   " font-family: monospace; padding: 4px; }");
+    m_timingOverlay->move(6, 6);
+    m_timingOverlay->hide();
+
+    updateRetainedImages();
+
+    // 参数调节时在后台线程处理，拖动滑块不卡界面
+    m_imageProcessor->setAsyncEnabled(true);
+
     this->setAutoFillBackground(true);
     QPixmap pixMap(":/img/bg.jpg");
     QPalette backPalette;
@@ -59,19 +74,6 @@ void Widget::initializeUI()
     ui->sb_outPutWidth->setSingleStep(m_stepValue);
     ui->sb_outPutHeight->setSingleStep(m_stepValue);
 
-    // 设置默认值
-    ui->sb_Point1x->setValue(60);
-    ui->sb_Point1y->setValue(41);
-    ui->sb_Point2x->setValue(621);
-    ui->sb_Point2y->setValue(36);
-    ui->sb_Point3x->setValue(586);
-    ui->sb_Point3y->setValue(528);
-    ui->sb_Point4x->setValue(55);
-    ui->sb_Point4y->setValue(582);
-
-    ui->sb_outPutWidth->setValue(612);
-    ui->sb_outPutHeight->setValue(580);
-
     ui->sld_step->setRange(1, 10);
     ui->sld_step->setValue(m_stepValue);
     ui->sld_step->setTickInterval(2);
@@ -80,49 +82,154 @@ void Widget::initializeUI()
     // ******************************************
     ui->dsb_simgaX->setRange(0, 4);
     ui->dsb_simgaX->setSingleStep(0.1);
-    ui->dsb_simgaX->setValue(2.0);
     ui->dsb_simgaY->setRange(0, 4);
     ui->dsb_simgaY->setSingleStep(0.1);
-    ui->dsb_simgaY->setValue(2.0);
 
     // ******************************************
     ui->sld_Threshold1->setRange(0, 255);
-    ui->sld_Threshold1->setValue(50);
     ui->sld_Threshold2->setRange(0, 255);
-    ui->sld_Threshold2->setValue(150);
-
-    // ******************************************
-    ui->sb_minRadius->setValue(281);
-    ui->sb_maxRadius->setValue(377);
 
     // ******************************************
     ui->sb_rho->setRange(0, 10);
     ui->sb_rho->setSingleStep(1);
-    ui->sb_rho->setValue(1);
 
     ui->dsb_theta->setRange(0, CV_PI*2);
     ui->dsb_theta->setSingleStep(0.1);
-    ui->dsb_theta->setValue(CV_PI/180);
+    ui->dsb_theta->setDecimals(6);
 
     ui->sb_threshold->setRange(0, 255);
     ui->sb_threshold->setSingleStep(1);
-    ui->sb_threshold->setValue(30);
 
     ui->sb_minLineLength->setRange(0, 255);
     ui->sb_minLineLength->setSingleStep(1);
-    ui->sb_minLineLength->setValue(50);
 
     ui->sb_maxLineGap->setRange(0, 255);
     ui->sb_maxLineGap->setSingleStep(1);
-    ui->sb_maxLineGap->setValue(150);
 
     // ******************************************
     ui->sb_minValue->setRange(-5, 10);
     ui->sb_minValue->setSingleStep(1);
-    ui->sb_minValue->setValue(0);
     ui->sb_maxValue->setRange(0, 50);
     ui->sb_maxValue->setSingleStep(1);
-    ui->sb_maxValue->setValue(15);
+
+    // 默认值只在 GaugeParams 中定义一处，控件显示处理器当前的参数
+    showParameters(m_imageProcessor->parameters());
+}
+
+// 把参数显示到控件上。参数已经在处理器中，显示时不触发各控件的槽函数。
+// 控件按范围截断或取整后的值与参数不同时，把控件上的值写回处理器
+void Widget::showParameters(const GaugeParams &params)
+{
+    const QList<QWidget *> controls = {
+        ui->sb_Point1x, ui->sb_Point1y, ui->sb_Point2x, ui->sb_Point2y,
+        ui->sb_Point3x, ui->sb_Point3y, ui->sb_Point4x, ui->sb_Point4y,
+        ui->sb_outPutWidth, ui->sb_outPutHeight,
+        ui->dsb_simgaX, ui->dsb_simgaY,
+        ui->sld_Threshold1, ui->sld_Threshold2,
+        ui->sb_minRadius, ui->sb_maxRadius,
+        ui->sb_rho, ui->dsb_theta, ui->sb_threshold, ui->sb_minLineLength, ui->sb_maxLineGap,
+        ui->sb_minValue, ui->sb_maxValue
+    };
+    for (QWidget *control : controls)
+    {
+        control->blockSignals(true);
+    }
+
+    if (params.sourcePoints.size() == 4)
+    {
+        ui->sb_Point1x->setValue(qRound(params.sourcePoints[0].x));
+        ui->sb_Point1y->setValue(qRound(params.sourcePoints[0].y));
+        ui->sb_Point2x->setValue(qRound(params.sourcePoints[1].x));
+        ui->sb_Point2y->setValue(qRound(params.sourcePoints[1].y));
+        ui->sb_Point3x->setValue(qRound(params.sourcePoints[2].x));
+        ui->sb_Point3y->setValue(qRound(params.sourcePoints[2].y));
+        ui->sb_Point4x->setValue(qRound(params.sourcePoints[3].x));
+        ui->sb_Point4y->setValue(qRound(params.sourcePoints[3].y));
+    }
+    ui->sb_outPutWidth->setValue(params.outputWidth);
+    ui->sb_outPutHeight->setValue(params.outputHeight);
+
+    ui->dsb_simgaX->setValue(params.sigmaX);
+    ui->dsb_simgaY->setValue(params.sigmaY);
+
+    ui->sld_Threshold1->setValue(params.cannyThreshold1);
+    ui->sld_Threshold2->setValue(params.cannyThreshold2);
+
+    ui->sb_minRadius->setValue(params.minRadius);
+    ui->sb_maxRadius->setValue(params.maxRadius);
+
+    ui->sb_rho->setValue(params.rho);
+    ui->dsb_theta->setValue(params.theta);
+    ui->sb_threshold->setValue(params.threshold);
+    ui->sb_minLineLength->setValue(params.minLineLength);
+    ui->sb_maxLineGap->setValue(params.maxLineGap);
+
+    ui->sb_minValue->setValue(qRound(params.gaugeMinValue));
+    ui->sb_maxValue->setValue(qRound(params.gaugeMaxValue));
+
+    for (QWidget *control : controls)
+    {
+        control->blockSignals(false);
+    }
+
+    // 图像比透视区域或输出尺寸小、量程超出控件范围、小数点位取整时，控件显示的值与参数不同。
+    // 以控件上的值为准写回处理器（与调用方的图像加载、配置加载在同一个参数事务中处理），显示的就是实际处理的参数
+    const GaugeParams shown = controlParameters(params);
+    if (!sameControlParameters(shown, params))
+    {
+        m_imageProcessor->beginUpdate();
+        m_imageProcessor->setParameters(shown);
+        m_imageProcessor->endUpdate();
+    }
+}
+
+// params 中有对应控件的字段换成控件上的值，其余字段保留
+GaugeParams Widget::controlParameters(const GaugeParams &params) const
+{
+    GaugeParams shown = params;
+    if (shown.sourcePoints.size() == 4)
+    {
+        shown.sourcePoints = {
+            cv::Point2f(ui->sb_Point1x->value(), ui->sb_Point1y->value()),
+            cv::Point2f(ui->sb_Point2x->value(), ui->sb_Point2y->value()),
+            cv::Point2f(ui->sb_Point3x->value(), ui->sb_Point3y->value()),
+            cv::Point2f(ui->sb_Point4x->value(), ui->sb_Point4y->value())
+        };
+    }
+    shown.outputWidth = ui->sb_outPutWidth->value();
+    shown.outputHeight = ui->sb_outPutHeight->value();
+
+    shown.sigmaX = ui->dsb_simgaX->value();
+    shown.sigmaY = ui->dsb_simgaY->value();
+
+    shown.cannyThreshold1 = ui->sld_Threshold1->value();
+    shown.cannyThreshold2 = ui->sld_Threshold2->value();
+
+    shown.minRadius = ui->sb_minRadius->value();
+    shown.maxRadius = ui->sb_maxRadius->value();
+
+    shown.rho = ui->sb_rho->value();
+    shown.theta = ui->dsb_theta->value();
+    shown.threshold = ui->sb_threshold->value();
+    shown.minLineLength = ui->sb_minLineLength->value();
+    shown.maxLineGap = ui->sb_maxLineGap->value();
+
+    shown.gaugeMinValue = ui->sb_minValue->value();
+    shown.gaugeMaxValue = ui->sb_maxValue->value();
+    return shown;
+}
+
+// 只比较有控件的字段
+bool Widget::sameControlParameters(const GaugeParams &a, const GaugeParams &b)
+{
+    return a.sourcePoints == b.sourcePoints
+            && a.outputWidth == b.outputWidth && a.outputHeight == b.outputHeight
+            && a.sigmaX == b.sigmaX && a.sigmaY == b.sigmaY
+            && a.cannyThreshold1 == b.cannyThreshold1 && a.cannyThreshold2 == b.cannyThreshold2
+            && a.minRadius == b.minRadius && a.maxRadius == b.maxRadius
+            && a.rho == b.rho && a.theta == b.theta && a.threshold == b.threshold
+            && a.minLineLength == b.minLineLength && a.maxLineGap == b.maxLineGap
+            && a.gaugeMinValue == b.gaugeMinValue && a.gaugeMaxValue == b.gaugeMaxValue;
 }
 
 void Widget::setupConnections()
@@ -147,11 +254,41 @@ void Widget::on_btn_openPic_clicked()
 
     if (!fileName.isEmpty())
     {
+        // 加载图像和初始化约 30 个控件的参数修改合并为一次处理
+        m_imageProcessor->beginUpdate();
         if (m_imageProcessor->loadImage(fileName))
         {
             updateSpinBoxRanges();
             initializeUI();
         }
+        m_imageProcessor->endUpdate();
+    }
+}
+
+// 加载仪表配置：参数、透视映射表和锁定的表盘圆一起恢复，处理直接从锁定状态开始
+void Widget::on_btn_loadProfile_clicked()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "加载仪表配置", QString(), "仪表配置 (*.json)");
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+
+    m_imageProcessor->beginUpdate();
+    if (m_imageProcessor->loadProfile(fileName))
+    {
+        showParameters(m_imageProcessor->parameters());
+    }
+    m_imageProcessor->endUpdate();
+}
+
+// 保存仪表配置：当前参数加上由参数算出的映射表、表盘圆和刻度表
+void Widget::on_btn_saveProfile_clicked()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "保存仪表配置", QString(), "仪表配置 (*.json)");
+    if (!fileName.isEmpty())
+    {
+        m_imageProcessor->saveProfile(fileName);
     }
 }
 
@@ -193,7 +330,46 @@ void Widget::updateDisplay()
 
     ui->pixelViewer_line->setImage(m_imageProcessor->getLineImage());
 
-    ui->led_Display->setText(QString("%1").arg(m_imageProcessor->getReading()));
+    // 未检测到表盘或指针时不显示读数
+    const GaugeResult &result = m_imageProcessor->getResult();
+    ui->led_Display->setText(result.isValid() ? QString("%1").arg(result.reading) : QString("--"));
+
+    updateTimingOverlay();
+}
+
+// 只保留界面上有视图显示的中间图像
+void Widget::updateRetainedImages()
+{
+    int images = ImageProcessor::NoImages;
+    if (ui->pixelViewer_PTtransform->isVisibleTo(this)) images |= ImageProcessor::PerspectiveImage;
+    if (ui->pixelViewer_gray->isVisibleTo(this)) images |= ImageProcessor::GrayImage;
+    if (ui->pixelViewer_Gauss->isVisibleTo(this)) images |= ImageProcessor::BlurredImage;
+    if (ui->pixelViewer_edge->isVisibleTo(this)) images |= ImageProcessor::EdgesImage;
+    if (ui->pixelViewer_cricle->isVisibleTo(this)) images |= ImageProcessor::CircleOverlay;
+    if (ui->pixelViewer_line->isVisibleTo(this)) images |= ImageProcessor::LineOverlay;
+    m_imageProcessor->setRetainedImages(images);
+}
+
+void Widget::updateTimingOverlay()
+{
+    const StageTimings &timings = m_imageProcessor->getTimings();
+    if (timings.empty())
+    {
+        m_timingOverlay->hide();
+        return;
+    }
+
+    QStringList lines;
+    lines << QString("%1  %2 ms").arg(timings.trigger).arg(timings.totalMs, 0, 'f', 1);
+    for (const StageTiming &stage : timings.stages)
+    {
+        lines << QString("  %1 %2").arg(stage.name, -12)
+                 .arg(stage.cached ? QString("缓存") : QString("%1 ms").arg(stage.durationMs, 0, 'f', 1));
+    }
+    m_timingOverlay->setText(lines.join('\n'));
+    m_timingOverlay->adjustSize();
+    m_timingOverlay->show();
+    m_timingOverlay->raise();
 }
 
 // --------------------透视变换参数槽函数--------------------
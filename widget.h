@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include <QDebug>
+#include <QLabel>
 #include "imageprocessor.h"
 
 QT_BEGIN_NAMESPACE
@@ -22,6 +23,8 @@ public:
     void updatePerspectivePoints();
 private slots:
     void on_btn_openPic_clicked();
+    void on_btn_loadProfile_clicked();
+    void on_btn_saveProfile_clicked();
     void onProcessingCompleted();
     void onErrorOccurred(const QString &errorMessage);
 
@@ -69,13 +72,19 @@ private slots:
 
 private:
     void initializeUI();
+    void showParameters(const GaugeParams &params);
+    GaugeParams controlParameters(const GaugeParams &params) const;
+    static bool sameControlParameters(const GaugeParams &a, const GaugeParams &b);
     void setupConnections();
     void updateSpinBoxRanges();
     void updateDisplay();
+    void updateTimingOverlay();
+    void updateRetainedImages();
 
 private:
     Ui::Widget *ui;
     ImageProcessor *m_imageProcessor;
     int m_stepValue;
+    QLabel *m_timingOverlay;
 };
 #endif // WIDGET_H